@@ -24,6 +24,8 @@ echo "start unit test in the folder:$(pwd)"
 ../bin/pppParallelTests
 ../bin/pppAppTests  
 ../bin/pppGeomTests
+../bin/propertyContainerTest
+if [ -f ../bin/propertyContainerConcurrentTest ]; then ../bin/propertyContainerConcurrentTest; fi
 
 
 echo "start python tests in the folder:$(pwd)"
@@ -0,0 +1,209 @@
+// license
+#ifndef PPP_BOUND_BOX_ARRAY_H
+#define PPP_BOUND_BOX_ARRAY_H
+
+#include "GeometryTypes.h"
+#include <limits>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace Geom
+{
+    using namespace PPP;
+
+    /// \ingroup Geom
+    /**
+     * \brief packed axis-aligned bound boxes of all items, one contiguous column per bound (xmin, ..., zmax)
+     *
+     * Values are from `Bnd_Box::Get()`, so the gap of Bnd_Box is included and open directions are
+     * `Precision::Infinite()`. A void box is packed as inverted infinity (min = +inf, max = -inf),
+     * which never overlaps any other box.
+     *
+     * One-vs-many kernels use AVX-512 (8 lanes) or AVX2 (4 lanes) if the compiler targets them
+     * (cmake option `PPP_USE_NATIVE_ARCH`), otherwise the scalar loop is used.
+     * Result is identical to `OccUtils::isBndBoxOverlapped()`.
+     *
+     * Thread-safety: same as `std::vector`, `set()` on different item indices can run in parallel after `resize()`.
+     */
+    class BoundBoxArray
+    {
+    public:
+        static const std::size_t Dim = 3;
+        /// same as `Precision::Confusion()`
+        static constexpr double Confusion = 1e-7;
+
+    private:
+        /// myBounds[0..2] for xmin, ymin, zmin; myBounds[3..5] for xmax, ymax, zmax
+        VectorType<double> myBounds[Dim * 2];
+
+    public:
+        BoundBoxArray() = default;
+        explicit BoundBoxArray(const VectorType<Bnd_Box>& boxes)
+        {
+            resize(boxes.size());
+            for (std::size_t i = 0; i < boxes.size(); i++)
+                set(i, boxes[i]);
+        }
+
+        void resize(const std::size_t n)
+        {
+            for (std::size_t d = 0; d < Dim; d++)
+            {
+                myBounds[d].resize(n, std::numeric_limits<double>::infinity());
+                myBounds[d + Dim].resize(n, -std::numeric_limits<double>::infinity());
+            }
+        }
+
+        inline std::size_t size() const
+        {
+            return myBounds[0].size();
+        }
+
+        void set(const ItemIndexType i, const Bnd_Box& b)
+        {
+            double v[Dim * 2];
+            unpack(b, v);
+            for (std::size_t d = 0; d < Dim * 2; d++)
+                myBounds[d][i] = v[d];
+        }
+
+        /// bounds of item i in the sequence of xmin, ymin, zmin, xmax, ymax, zmax
+        void get(const ItemIndexType i, double v[Dim * 2]) const
+        {
+            for (std::size_t d = 0; d < Dim * 2; d++)
+                v[d] = myBounds[d][i];
+        }
+
+        /// Bnd_Box::Get() throws for a void box, so void is converted into inverted infinity
+        static void unpack(const Bnd_Box& b, double v[Dim * 2])
+        {
+            if (b.IsVoid())
+            {
+                for (std::size_t d = 0; d < Dim; d++)
+                {
+                    v[d] = std::numeric_limits<double>::infinity();
+                    v[d + Dim] = -std::numeric_limits<double>::infinity();
+                }
+            }
+            else
+                b.Get(v[0], v[1], v[2], v[3], v[4], v[5]);
+        }
+
+        /// zero gap is not safe for float point comparison, the same as `OccUtils::isBndBoxOverlapped()`
+        static inline double normalizedGap(double gap)
+        {
+            if (gap < 0 and gap > -Confusion)
+                gap = -Confusion;
+            if (gap > 0 and gap < Confusion)
+                gap = Confusion;
+            return gap;
+        }
+
+        /// scalar test for a single pair, without unpacking Bnd_Box
+        bool overlapped(const ItemIndexType i, const ItemIndexType j, const double gap) const
+        {
+            const double g = normalizedGap(gap);
+            bool ret = true;
+            for (std::size_t d = 0; d < Dim; d++)
+                ret &= (myBounds[d][i] <= myBounds[d + Dim][j] + g) & (myBounds[d + Dim][i] >= myBounds[d][j] - g);
+            return ret;
+        }
+
+        /**
+         * one box against items in range [begin, end), mask[k - begin] = 1 if overlapped with item k
+         * @param box bounds in the sequence of xmin, ymin, zmin, xmax, ymax, zmax
+         * @return the count of overlapped items
+         */
+        std::size_t overlapMask(const double box[Dim * 2], const std::size_t begin, const std::size_t end,
+                                const double gap, char* mask) const
+        {
+            const double g = normalizedGap(gap);
+            // box i overlaps box j if i.min <= j.max + gap and i.max >= j.min - gap, for all dimensions
+            const double lo[Dim] = {box[0] - g, box[1] - g, box[2] - g}; // compared with item max
+            const double hi[Dim] = {box[3] + g, box[4] + g, box[5] + g}; // compared with item min
+            const double* xmin = myBounds[0].data();
+            const double* ymin = myBounds[1].data();
+            const double* zmin = myBounds[2].data();
+            const double* xmax = myBounds[3].data();
+            const double* ymax = myBounds[4].data();
+            const double* zmax = myBounds[5].data();
+
+            std::size_t count = 0;
+            std::size_t k = begin;
+#if defined(__AVX512F__)
+            const __m512d lx = _mm512_set1_pd(lo[0]), ly = _mm512_set1_pd(lo[1]), lz = _mm512_set1_pd(lo[2]);
+            const __m512d hx = _mm512_set1_pd(hi[0]), hy = _mm512_set1_pd(hi[1]), hz = _mm512_set1_pd(hi[2]);
+            for (; k + 8 <= end; k += 8)
+            {
+                __mmask8 m = _mm512_cmp_pd_mask(_mm512_loadu_pd(xmax + k), lx, _CMP_GE_OQ);
+                m = _mm512_mask_cmp_pd_mask(m, _mm512_loadu_pd(ymax + k), ly, _CMP_GE_OQ);
+                m = _mm512_mask_cmp_pd_mask(m, _mm512_loadu_pd(zmax + k), lz, _CMP_GE_OQ);
+                m = _mm512_mask_cmp_pd_mask(m, _mm512_loadu_pd(xmin + k), hx, _CMP_LE_OQ);
+                m = _mm512_mask_cmp_pd_mask(m, _mm512_loadu_pd(ymin + k), hy, _CMP_LE_OQ);
+                m = _mm512_mask_cmp_pd_mask(m, _mm512_loadu_pd(zmin + k), hz, _CMP_LE_OQ);
+                for (unsigned l = 0; l < 8; l++)
+                {
+                    mask[k - begin + l] = (m >> l) & 1;
+                    count += (m >> l) & 1;
+                }
+            }
+#elif defined(__AVX2__)
+            const __m256d lx = _mm256_set1_pd(lo[0]), ly = _mm256_set1_pd(lo[1]), lz = _mm256_set1_pd(lo[2]);
+            const __m256d hx = _mm256_set1_pd(hi[0]), hy = _mm256_set1_pd(hi[1]), hz = _mm256_set1_pd(hi[2]);
+            for (; k + 4 <= end; k += 4)
+            {
+                __m256d m = _mm256_cmp_pd(_mm256_loadu_pd(xmax + k), lx, _CMP_GE_OQ);
+                m = _mm256_and_pd(m, _mm256_cmp_pd(_mm256_loadu_pd(ymax + k), ly, _CMP_GE_OQ));
+                m = _mm256_and_pd(m, _mm256_cmp_pd(_mm256_loadu_pd(zmax + k), lz, _CMP_GE_OQ));
+                m = _mm256_and_pd(m, _mm256_cmp_pd(_mm256_loadu_pd(xmin + k), hx, _CMP_LE_OQ));
+                m = _mm256_and_pd(m, _mm256_cmp_pd(_mm256_loadu_pd(ymin + k), hy, _CMP_LE_OQ));
+                m = _mm256_and_pd(m, _mm256_cmp_pd(_mm256_loadu_pd(zmin + k), hz, _CMP_LE_OQ));
+                const int bits = _mm256_movemask_pd(m);
+                for (unsigned l = 0; l < 4; l++)
+                {
+                    mask[k - begin + l] = (bits >> l) & 1;
+                    count += (bits >> l) & 1;
+                }
+            }
+#endif
+            for (; k < end; k++) // scalar fallback and the tail
+            {
+                const char m = (xmax[k] >= lo[0]) & (ymax[k] >= lo[1]) & (zmax[k] >= lo[2]) & (xmin[k] <= hi[0]) &
+                               (ymin[k] <= hi[1]) & (zmin[k] <= hi[2]);
+                mask[k - begin] = m;
+                count += m;
+            }
+            return count;
+        }
+
+        /// indices of items in range [begin, end) overlapped with the given box
+        VectorType<ItemIndexType> overlappedItems(const double box[Dim * 2], const std::size_t begin,
+                                                  const std::size_t end, const double gap) const
+        {
+            VectorType<ItemIndexType> ids;
+            if (begin >= end)
+                return ids;
+            VectorType<char> mask(end - begin);
+            ids.reserve(overlapMask(box, begin, end, gap, mask.data()));
+            for (std::size_t k = begin; k < end; k++)
+            {
+                if (mask[k - begin])
+                    ids.push_back(k);
+            }
+            return ids;
+        }
+
+        /// indices of items j > i whose box is overlapped with the box of item i
+        VectorType<ItemIndexType> overlappedItems(const ItemIndexType i, const double gap) const
+        {
+            double box[Dim * 2];
+            get(i, box);
+            return overlappedItems(box, i + 1, size(), gap);
+        }
+    };
+
+} // namespace Geom
+
+#endif
@@ -20,14 +20,18 @@ namespace Geom
 
     private:
         VectorType<Bnd_Box> myShapeBoundBoxes;
+        /// the same boxes packed in columns, for one-vs-many overlapping test
+        BoundBoxArray myPackedBoundBoxes;
 #if OCC_VERSION_HEX >= 0x070300
         VectorType<Bnd_OBB> myShapeOrientedBoundBoxes;
+        OrientedBoundBoxArray myPackedOrientedBoundBoxes;
 #endif
     public:
         BoundBoxBuilder()
         {
             /// myCharacteristics["requiredProperties"]  have been set by parent class ctor()
-            myCharacteristics["producedProperties"] = {"myShapeBoundBoxes", "myShapeOrientedBoundBoxes"};
+            myCharacteristics["producedProperties"] = {"myShapeBoundBoxes", "myPackedBoundBoxes",
+                                                       "myShapeOrientedBoundBoxes", "myPackedOrientedBoundBoxes"};
         }
 
         virtual void prepareInput() override final
@@ -35,16 +39,20 @@ namespace Geom
             GeometryProcessor::prepareInput();
             auto count = myInputData->itemCount();
             myShapeBoundBoxes.resize(count);
+            myPackedBoundBoxes.resize(count);
 #if OCC_VERSION_HEX >= 0x070300
             myShapeOrientedBoundBoxes.resize(count);
+            myPackedOrientedBoundBoxes.resize(count);
 #endif
         }
 
         virtual void prepareOutput() override final
         {
-            myOutputData->emplace("myShapeBoundBoxes", std::move(myShapeBoundBoxes));
+            myOutputData->emplace(PropertyKeys::ShapeBoundBoxes, std::move(myShapeBoundBoxes));
+            myOutputData->emplace(PropertyKeys::PackedBoundBoxes, std::move(myPackedBoundBoxes));
 #if OCC_VERSION_HEX >= 0x070300
-            myOutputData->emplace("myShapeOrientedBoundBoxes", std::move(myShapeOrientedBoundBoxes));
+            myOutputData->emplace(PropertyKeys::ShapeOrientedBoundBoxes, std::move(myShapeOrientedBoundBoxes));
+            myOutputData->emplace(PropertyKeys::PackedOrientedBoundBoxes, std::move(myPackedOrientedBoundBoxes));
 #endif
         }
 
@@ -56,10 +64,12 @@ namespace Geom
             /// default zero gap, here a global tolerance is used, set in GeometryProcessor
             boundingBox.SetGap(toleranceThreshold);
             BRepBndLib::Add(s, boundingBox); // which type, simple global coordinate
+            myPackedBoundBoxes.set(index, boundingBox);
             myShapeBoundBoxes[index] = std::move(boundingBox);
 #if OCC_VERSION_HEX >= 0x070300
             Bnd_OBB obb;
             BRepBndLib::AddOBB(s, obb);
+            myPackedOrientedBoundBoxes.set(index, obb);
             myShapeOrientedBoundBoxes[index] = obb; // std::move(obb); does not work!
 #endif
         }
@@ -0,0 +1,239 @@
+// license
+#ifndef PPP_BOUND_BOX_TREE_H
+#define PPP_BOUND_BOX_TREE_H
+
+#include "BoundBoxArray.h"
+
+namespace Geom
+{
+    using namespace PPP;
+
+    /// relation between the query box and the item bound box, for `BoundBoxTree::query()`
+    enum class BoundBoxQueryType
+    {
+        Coincident, ///!< query box is inside the item box within relative tolerance, `isBndBoxCoincident()`
+        Intersect,  ///!< item box overlaps the query box within an absolute gap, `isBndBoxOverlapped()`
+        Contain,    ///!< item box is contained by the query box within an absolute tolerance
+    };
+    NLOHMANN_JSON_SERIALIZE_ENUM(BoundBoxQueryType, {
+                                                        {BoundBoxQueryType::Coincident, "Coincident"},
+                                                        {BoundBoxQueryType::Intersect, "Intersect"},
+                                                        {BoundBoxQueryType::Contain, "Contain"},
+                                                    });
+
+    /// \ingroup Geom
+    /**
+     * \brief static bounding volume hierarchy (BVH) over packed item bound boxes, for region queries
+     *
+     * The tree is built once by recursive median split along the longest axis of box centers,
+     * each leaf holds at most `LeafSize` items, void boxes are excluded.
+     * A query traverses only the nodes whose bound box can satisfy the relation,
+     * so that M queries on N items cost about O(M log N) instead of O(M N) for small query regions.
+     *
+     * The tree is read-only after build, so queries can run in parallel.
+     */
+    class BoundBoxTree
+    {
+    public:
+        static const std::size_t Dim = BoundBoxArray::Dim;
+        static const std::size_t LeafSize = 4;
+
+    private:
+        struct Node
+        {
+            double bounds[Dim * 2]; /// xmin, ymin, zmin, xmax, ymax, zmax of all boxes in this subtree
+            std::size_t begin;      /// item range [begin, end) in `myItems` for leaf node
+            std::size_t end;
+            std::size_t left = 0; /// child node index, 0 for leaf node, since root can not be a child
+            std::size_t right = 0;
+        };
+
+        VectorType<Node> myNodes;
+        VectorType<ItemIndexType> myItems;  /// item indices reordered by the tree build
+        VectorType<double> myItemBounds;    /// item bounds in the `myItems` order, Dim * 2 per item
+        VectorType<double> myCenters;       /// temporary for build
+
+    public:
+        BoundBoxTree() = default;
+        explicit BoundBoxTree(const BoundBoxArray& boxes)
+        {
+            build(boxes);
+        }
+
+        void build(const BoundBoxArray& boxes)
+        {
+            myNodes.clear();
+            myItems.clear();
+            double b[Dim * 2];
+            for (std::size_t i = 0; i < boxes.size(); i++)
+            {
+                boxes.get(i, b);
+                if (b[0] <= b[3] and b[1] <= b[4] and b[2] <= b[5]) // void box is excluded
+                    myItems.push_back(i);
+            }
+            myCenters.resize(boxes.size() * Dim);
+            VectorType<double> allBounds(boxes.size() * Dim * 2);
+            for (const auto i : myItems)
+            {
+                boxes.get(i, &allBounds[i * Dim * 2]);
+                for (std::size_t d = 0; d < Dim; d++)
+                    myCenters[i * Dim + d] = 0.5 * (allBounds[i * Dim * 2 + d] + allBounds[i * Dim * 2 + d + Dim]);
+            }
+            if (myItems.size())
+            {
+                myNodes.reserve(2 * myItems.size() / LeafSize + 1);
+                buildNode(0, myItems.size(), allBounds);
+            }
+            myItemBounds.resize(myItems.size() * Dim * 2);
+            for (std::size_t k = 0; k < myItems.size(); k++)
+                std::copy_n(&allBounds[myItems[k] * Dim * 2], Dim * 2, &myItemBounds[k * Dim * 2]);
+            VectorType<double>().swap(myCenters);
+        }
+
+        inline std::size_t nodeCount() const
+        {
+            return myNodes.size();
+        }
+
+        /**
+         * find all items satisfying the relation with the query box
+         * @param box  query box bounds in the sequence of xmin, ymin, zmin, xmax, ymax, zmax
+         * @param tolerance relative tolerance for Coincident, absolute gap or tolerance for Intersect and Contain
+         * @return item indices in ascending order
+         */
+        VectorType<ItemIndexType> query(const double box[Dim * 2], const BoundBoxQueryType type,
+                                        const double tolerance) const
+        {
+            VectorType<ItemIndexType> result;
+            if (myNodes.empty() or box[0] > box[3] or box[1] > box[4] or box[2] > box[5])
+                return result;
+            const double tol = (type == BoundBoxQueryType::Coincident) ? std::abs(tolerance)
+                                                                       : BoundBoxArray::normalizedGap(tolerance);
+            std::vector<std::size_t> stack = {0};
+            while (stack.size())
+            {
+                const Node& node = myNodes[stack.back()];
+                stack.pop_back();
+                if (not nodeMayMatch(node.bounds, box, type, tol))
+                    continue;
+                if (node.left)
+                {
+                    stack.push_back(node.left);
+                    stack.push_back(node.right);
+                }
+                else
+                {
+                    for (std::size_t k = node.begin; k < node.end; k++)
+                    {
+                        if (itemMatch(&myItemBounds[k * Dim * 2], box, type, tol))
+                            result.push_back(myItems[k]);
+                    }
+                }
+            }
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+
+    private:
+        /// build node for items [begin, end) of myItems, return the node index
+        std::size_t buildNode(const std::size_t begin, const std::size_t end, const VectorType<double>& allBounds)
+        {
+            const std::size_t index = myNodes.size();
+            myNodes.emplace_back();
+            Node node;
+            node.begin = begin;
+            node.end = end;
+            for (std::size_t d = 0; d < Dim; d++)
+            {
+                node.bounds[d] = std::numeric_limits<double>::infinity();
+                node.bounds[d + Dim] = -std::numeric_limits<double>::infinity();
+            }
+            double cmin[Dim], cmax[Dim];
+            std::fill_n(cmin, Dim, std::numeric_limits<double>::infinity());
+            std::fill_n(cmax, Dim, -std::numeric_limits<double>::infinity());
+            for (std::size_t k = begin; k < end; k++)
+            {
+                const double* b = &allBounds[myItems[k] * Dim * 2];
+                const double* c = &myCenters[myItems[k] * Dim];
+                for (std::size_t d = 0; d < Dim; d++)
+                {
+                    node.bounds[d] = std::min(node.bounds[d], b[d]);
+                    node.bounds[d + Dim] = std::max(node.bounds[d + Dim], b[d + Dim]);
+                    cmin[d] = std::min(cmin[d], c[d]);
+                    cmax[d] = std::max(cmax[d], c[d]);
+                }
+            }
+
+            if (end - begin > LeafSize)
+            {
+                std::size_t axis = 0;
+                for (std::size_t d = 1; d < Dim; d++)
+                {
+                    if (cmax[d] - cmin[d] > cmax[axis] - cmin[axis])
+                        axis = d;
+                }
+                const std::size_t mid = begin + (end - begin) / 2;
+                std::nth_element(myItems.begin() + begin, myItems.begin() + mid, myItems.begin() + end,
+                                 [&](const ItemIndexType a, const ItemIndexType b) {
+                                     return myCenters[a * Dim + axis] < myCenters[b * Dim + axis];
+                                 });
+                node.left = buildNode(begin, mid, allBounds);
+                node.right = buildNode(mid, end, allBounds);
+            }
+            myNodes[index] = node; // myNodes may be reallocated during recursion, assign at the end
+            return index;
+        }
+
+        /// necessary condition for any item in the subtree to match, using the union bound of node
+        static inline bool nodeMayMatch(const double* nb, const double* q, const BoundBoxQueryType type,
+                                        const double tol)
+        {
+            for (std::size_t d = 0; d < Dim; d++)
+            {
+                if (type == BoundBoxQueryType::Coincident)
+                {
+                    // item tolerance is not bigger than tolerance computed from node extent
+                    const double t = std::max(std::max(q[d + Dim] - q[d], nb[d + Dim] - nb[d]) * tol,
+                                              BoundBoxArray::Confusion);
+                    if (q[d] < nb[d] - t or q[d + Dim] > nb[d + Dim] + t)
+                        return false;
+                }
+                else // both Intersect and Contain need overlapping
+                {
+                    if (nb[d] > q[d + Dim] + tol or nb[d + Dim] < q[d] - tol)
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        static inline bool itemMatch(const double* b, const double* q, const BoundBoxQueryType type,
+                                     const double tol)
+        {
+            for (std::size_t d = 0; d < Dim; d++)
+            {
+                if (type == BoundBoxQueryType::Coincident) // the same as `OccUtils::isBndBoxCoincident(q, b, tol)`
+                {
+                    const double t =
+                        std::max(std::max(q[d + Dim] - q[d], b[d + Dim] - b[d]) * tol, BoundBoxArray::Confusion);
+                    if (q[d] < b[d] - t or q[d + Dim] > b[d + Dim] + t)
+                        return false;
+                }
+                else if (type == BoundBoxQueryType::Intersect)
+                {
+                    if (b[d] > q[d + Dim] + tol or b[d + Dim] < q[d] - tol)
+                        return false;
+                }
+                else // Contain
+                {
+                    if (b[d] < q[d] - tol or b[d + Dim] > q[d + Dim] + tol)
+                        return false;
+                }
+            }
+            return true;
+        }
+    };
+
+} // namespace Geom
+
+#endif
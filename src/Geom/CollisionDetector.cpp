@@ -1,4 +1,5 @@
 #include "CollisionDetector.h"
+#include "PPP/Tracer.h"
 
 namespace Geom
 {
@@ -12,7 +13,7 @@ namespace Geom
     /// this is the second step to calcCollisionType(), after detectCollision
     CollisionType CollisionDetector::calcCollisionType(std::shared_ptr<BRepAlgoAPI_BuilderAlgo> mkGFA,
                                                        std::vector<Standard_Real> origVols,
-                                                       std::vector<ItemIndexType> ij)
+                                                       std::vector<ItemIndexType> ij, CollisionPhaseTimes* times)
     {
         using namespace OccUtils;
         size_t originalShapeCount = mkGFA->Arguments().Size();
@@ -36,8 +37,14 @@ namespace Geom
         {
             // size_t modifiedFaceCount = 0;
             // size_t modifiedEdgeCount = 0;
-            if (mkGFA->HasModified()) // has modified solids after general fuse
+            bool hasModified = false;
             {
+                PhaseTimer timer(times, CollisionPhaseTimes::History);
+                hasModified = mkGFA->HasModified();
+            }
+            if (hasModified) // has modified solids after general fuse
+            {
+                PhaseTimer volumeTimer(times, CollisionPhaseTimes::Volume);
                 if (origVols.size() == 0) // empty volume vector, default parameter value
                 {
                     origVols.clear();
@@ -65,6 +72,7 @@ namespace Geom
                     resVols.push_back(v);
                     allVol += v;
                 }
+                volumeTimer.stop();
 
                 auto min_result_volume = *std::min_element(resVols.cbegin(), resVols.cend());
                 if (min_result_volume < 0)
@@ -103,6 +111,7 @@ namespace Geom
                     // only surface contact is counted as Contact
                     if (floatEqual(allVol, sumOrigVols, 1e-3))
                     {
+                        PhaseTimer timer(times, CollisionPhaseTimes::Area);
                         /* count total face, edge and vertex may also not reliable */
                         Standard_Real totalArea = 0.0;
                         for (const auto& s : origShapes)
@@ -213,7 +222,7 @@ namespace Geom
         CollisionType ctype = CollisionType::NoCollision;
 
         bool completed = false;
-        std::vector<Standard_Real> vols = {(*myGeometryProperties)[i].volume, (*myGeometryProperties)[j].volume};
+        std::vector<Standard_Real> vols = {myGeometryPropertyStore->volume(i), myGeometryPropertyStore->volume(j)};
         std::vector<TopoDS_Shape> twoShapes = {item(i), item(j)};
 
         std::exception_ptr eptr;
@@ -221,16 +230,35 @@ namespace Geom
         std::vector<TopoDS_Shape> pieces;
         // retry by giving bigger tolerance, so tiny interference can be ignored
         std::shared_ptr<BRepAlgoAPI_BuilderAlgo> pFuser;
+        CollisionPhaseTimes phaseTimes;
+        CollisionPhaseTimes* times = phaseTiming ? &phaseTimes : nullptr;
+
+        // cooperative abort between retries, OCCT user-break within boolean operation
+        const auto pairStart = std::chrono::steady_clock::now();
+        auto elapsedTime = [&pairStart]() {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - pairStart).count();
+        };
+        // checked before volume, area and distance calculation, which can not be broken by OCCT user-break
+        auto deadlinePassed = [this, &elapsedTime]() { return pairTimeBudget > 0 and elapsedTime() >= pairTimeBudget; };
+        bool timedOut = false;
 
         // it is tricky to whether try fuzzy tol first of zero tol
         // mastu test data is working either way.
         // PCarmon's test data has exception if try zero tolerance first
         std::vector<double> tolerances = {tolerance, 0.0};
+        if (myRelaxedTolerance)
+            tolerances.insert(tolerances.begin(), tolerance * 10);
         const size_t NB_RETRY = tolerances.size();
 
         // try different tolerance to correct CollisionType::Error
         for (size_t r = 0; r < NB_RETRY && !completed; r++)
         {
+            const double remainedTime = pairTimeBudget - elapsedTime();
+            if (pairTimeBudget > 0 and remainedTime <= 0)
+            {
+                timedOut = true;
+                break;
+            }
             try
             {
                 auto mkGFA = std::make_shared<BRepAlgoAPI_BuilderAlgo>();
@@ -238,12 +266,25 @@ namespace Geom
                 // mkGFA->SetGlue(BOPAlgo_GlueShift); // quick in case of overlapping only, no interference
                 mkGFA->SetRunParallel(not internalMultiThreading);
                 // mkGFA->SetUseOBB(true);  // only if OCCT version is high enough
-                pieces = OccUtils::generalFuse(twoShapes, tolerances[r], mkGFA);
+                TraceSpan span("generalFuse", "occt", i, j);
+                if (times) // explicit PaveFiller to split intersection from building
+                    pieces = OccUtils::generalFuseInPhases(twoShapes, tolerances[r], mkGFA,
+                                                           times->seconds[CollisionPhaseTimes::Intersection],
+                                                           times->seconds[CollisionPhaseTimes::Building],
+                                                           pairTimeBudget > 0 ? remainedTime : 0.0);
+                else
+                    pieces = OccUtils::generalFuse(twoShapes, tolerances[r], mkGFA,
+                                                   pairTimeBudget > 0 ? remainedTime : 0.0);
 
                 pFuser = mkGFA;
                 completed = (pieces.size() == 2);
                 // no need to try again, is that possible to break inside try block?
             }
+            catch (const OccUtils::DeadlineExceeded&) // OCCT has been broken by the deadline
+            {
+                timedOut = true;
+                break;
+            }
             catch (...)
             {
                 eptr = std::current_exception();
@@ -274,12 +315,18 @@ namespace Geom
                 }
                 else
                 {
+                    if (deadlinePassed())
+                    {
+                        timedOut = true;
+                        break;
+                    }
                     bool isWeakInterferenceFixed = false;
-                    ctype = calcCollisionType(pFuser, vols, {i, j});
+                    ctype = calcCollisionType(pFuser, vols, {i, j}, times);
                     // if there is volume error, then try if they are not in contact to fix the error
                     // however, it seems always give zero distance, does not help
                     if (ctype >= CollisionType::Error and r == NB_RETRY - 1)
                     {
+                        PhaseTimer timer(times, CollisionPhaseTimes::Distance);
                         auto ctype_ret = solveErrorByDistanceCheck(i, j);
                         if (ctype_ret <= CollisionType::Clearance)
                             ctype = ctype_ret;
@@ -332,6 +379,12 @@ namespace Geom
                     }
                     else if (ctype == CollisionType::NoCollision)
                     {
+                        if (deadlinePassed())
+                        {
+                            timedOut = true;
+                            break;
+                        }
+                        PhaseTimer timer(times, CollisionPhaseTimes::Distance);
                         calcClearance(i, j); // also write myCollisionInfos
                     }
                     else
@@ -344,6 +397,15 @@ namespace Geom
                 break;
         } // end of retry
 
+        if (timedOut) // item locks are released once returned, no collision info until retried
+        {
+            LOG_F(WARNING, "item pair #%lu `%s`, #%lu `%s` exceeded time budget %.1f s, deferred", i,
+                  itemName(i).c_str(), j, itemName(j).c_str(), pairTimeBudget);
+            std::lock_guard<std::mutex> lock(myDeferredMutex);
+            myDeferredPairs.push_back({i, j});
+            return false;
+        }
+
         // here CollisionType::FaceContact must be saved to help resolve collision!
         if (ctype >= CollisionType::FaceContact) // vertex or edge contact is not reported
         {
@@ -358,25 +420,75 @@ namespace Geom
             auto df_original = generateDumpName("dump_ctypeErrorOriginal", {i, j}) + myDumpFileType;
             OccUtils::saveShape({item(i), item(j)}, df_original);
         }
+        if (times)
+            recordPhaseTimes(i, j, ctype, phaseTimes);
         // VLOG_F(LOGLEVEL_DEBUG, "contact type is %i solid pair #%lu `%s`, #%lu `%s`", ctype, i,
         // itemName(i).c_str(), j, itemName(j).c_str()); // disable this debug, using myCollisionInfos.json
         return completed && ctype == CollisionType::FaceContact;
     }
 
-    bool CollisionDetector::detectBoundBoxOverlapping(const ItemIndexType i, const ItemIndexType j, double clearance)
+    void CollisionDetector::recordPhaseTimes(const ItemIndexType i, const ItemIndexType j, const CollisionType ctype,
+                                             const CollisionPhaseTimes& times)
     {
-        bool overlapping = false;
-        if (myShapeOrientedBoundBoxes) // todo: add clearance support for OBB
-        {
-            const Bnd_OBB& thisObb = (*myShapeOrientedBoundBoxes)[i];
-            const Bnd_OBB& otherObb = (*myShapeOrientedBoundBoxes)[j];
-            overlapping = OccUtils::isBndBoxOverlapped(thisObb, otherObb);
-        }
-        else // if OBB is not supported, OCCT <7.3
+        std::lock_guard<std::mutex> lock(myPhaseTimeMutex);
+        myPhaseTimes[ctype].push_back({{i, j}, times});
+    }
+
+    void CollisionDetector::reportPhaseTimes(const std::string& file_name) const
+    {
+        const size_t phaseCount = CollisionPhaseTimes::PhaseCount;
+        json summary = json::object();
+        json pairs = json::array();
+        for (const auto& it : myPhaseTimes)
         {
-            overlapping = OccUtils::isBndBoxOverlapped((*myShapeBoundBoxes)[i], (*myShapeBoundBoxes)[j], clearance);
+            CollisionPhaseTimes sum, maximum;
+            for (const auto& p : it.second)
+            {
+                for (size_t k = 0; k < phaseCount; k++)
+                {
+                    sum.seconds[k] += p.second.seconds[k];
+                    maximum.seconds[k] = std::max(maximum.seconds[k], p.second.seconds[k]);
+                }
+                pairs.push_back({{"pair", p.first}, {"collisionType", it.first}, {"phaseTimes", p.second.toJson()}});
+            }
+            CollisionPhaseTimes mean = sum;
+            for (auto& t : mean.seconds)
+                t /= it.second.size();
+            const json ctype = it.first; // enum to string
+            summary[ctype.get<std::string>()] = {{"pairCount", it.second.size()},
+                                                 {"totalTime", sum.total()},
+                                                 {"sum", sum.toJson()},
+                                                 {"mean", mean.toJson()},
+                                                 {"max", maximum.toJson()}};
+
+            // whether time goes into boolean fragments or into the post-classification integrals
+            const double total = std::max(sum.total(), 1e-12);
+            const double boolean =
+                sum.seconds[CollisionPhaseTimes::Intersection] + sum.seconds[CollisionPhaseTimes::Building];
+            LOG_F(INFO,
+                  "%s: %lu pairs, %.3f s, intersection %.1f%%, building %.1f%%, history %.1f%%, "
+                  "volume %.1f%%, area %.1f%%, distance %.1f%%, boolean fragments %.1f%% in total",
+                  ctype.get<std::string>().c_str(), it.second.size(), sum.total(),
+                  100 * sum.seconds[CollisionPhaseTimes::Intersection] / total,
+                  100 * sum.seconds[CollisionPhaseTimes::Building] / total,
+                  100 * sum.seconds[CollisionPhaseTimes::History] / total,
+                  100 * sum.seconds[CollisionPhaseTimes::Volume] / total,
+                  100 * sum.seconds[CollisionPhaseTimes::Area] / total,
+                  100 * sum.seconds[CollisionPhaseTimes::Distance] / total, 100 * boolean / total);
         }
-        return overlapping;
+        std::ofstream o(file_name);
+        o << std::setw(4) << json{{"collisionTypes", summary}, {"pairs", pairs}} << std::endl;
+    }
+
+    bool CollisionDetector::detectBoundBoxOverlapping(const ItemIndexType i, const ItemIndexType j, double clearance)
+    {
+        // packed AABB test first, it is cheaper than OBB and has no Bnd_Box unpacking
+        if (not myPackedBoundBoxes->overlapped(i, j, clearance))
+            return false;
+        // then OBB as a tighter filter, with clearance support which is absent in `Bnd_OBB::IsOut()`
+        if (myPackedOrientedBoundBoxes)
+            return myPackedOrientedBoundBoxes->overlapped(i, j, clearance);
+        return true;
     }
 
     // call this method only if they has no interference
@@ -385,6 +497,7 @@ namespace Geom
         double dist = 1e10; // a very big number
         try
         {
+            TraceSpan span("distance", "occt", i, j);
             dist = OccUtils::distance(item(i), item(j));
         }
         catch (...)
@@ -421,6 +534,190 @@ namespace Geom
         }
     }
 
+    /// item i and j are locked by the parallel dispatcher, so row i and j of myCollisionInfos are safe to read
+    bool CollisionDetector::pairDeferred(const ItemIndexType i, const ItemIndexType j)
+    {
+        if (pairTimeBudget <= 0)
+            return false;
+        std::lock_guard<std::mutex> lock(myDeferredMutex);
+        const std::array<ItemIndexType, 2> p = {i, j};
+        return std::find(myDeferredPairs.cbegin(), myDeferredPairs.cend(), p) != myDeferredPairs.cend();
+    }
+
+    void CollisionDetector::processDeferredPairs()
+    {
+        if (myDeferredPairs.empty())
+            return;
+        const auto deferred = std::move(myDeferredPairs);
+        myDeferredPairs.clear();
+        const double budget = pairTimeBudget;
+        if (timeoutRetryFactor > 0)
+        {
+            LOG_F(INFO, "retry %lu deferred item pairs with time budget %.1f s and relaxed tolerance", deferred.size(),
+                  budget * timeoutRetryFactor);
+            pairTimeBudget = budget * timeoutRetryFactor; // set before retries start, no worker is running
+            myRelaxedTolerance = true;
+            // pairs in a round share no item, as the dispatcher guarantees by item locks, rounds run in sequence
+            std::vector<std::vector<std::array<ItemIndexType, 2>>> rounds;
+            std::vector<std::set<ItemIndexType>> roundItems;
+            for (const auto& p : deferred)
+            {
+                size_t r = 0;
+                while (r < rounds.size() and (roundItems[r].count(p[0]) or roundItems[r].count(p[1])))
+                    r++;
+                if (r == rounds.size())
+                {
+                    rounds.emplace_back();
+                    roundItems.emplace_back();
+                }
+                rounds[r].push_back(p);
+                roundItems[r].insert({p[0], p[1]});
+            }
+            // retries run in an arena of the configured thread count, not the default arena of all cores
+            tbb::task_arena arena(static_cast<int>(threadCount()));
+            arena.execute([&]() {
+                for (const auto& round : rounds)
+                {
+                    tbb::task_group g;
+                    for (const auto& p : round)
+                        g.run([this, p]() { processItemPair(p[0], p[1]); });
+                    g.wait();
+                }
+            });
+            pairTimeBudget = budget;
+            myRelaxedTolerance = false;
+        }
+
+        json records = json::array();
+        for (const auto& p : deferred)
+        {
+            const bool retried = timeoutRetryFactor > 0;
+            const bool resolved = retried and std::find(myDeferredPairs.cbegin(), myDeferredPairs.cend(), p) ==
+                                                  myDeferredPairs.cend();
+            records.push_back({{"pair", p},
+                               {"timeBudget", budget},
+                               {"retryTimeBudget", retried ? budget * timeoutRetryFactor : 0.0},
+                               {"resolved", resolved}});
+            if (not resolved)
+            {
+                const ItemIndexType i = p[0], j = p[1];
+                LOG_F(WARNING, "item pair #%lu `%s`, #%lu `%s` timed out, marked as CollisionType::Unknown", i,
+                      itemName(i).c_str(), j, itemName(j).c_str());
+                CollisionInfo info = {i, j, tolerance, CollisionType::Unknown};
+                myCollisionInfos[i].push_back(std::make_pair(j, info));
+                CollisionInfo info_j = {j, i, tolerance, CollisionType::Unknown};
+                myCollisionInfos[j].push_back(std::make_pair(i, info_j));
+                records.back()["reason"] = "timeout";
+            }
+        }
+        std::ofstream o(dataStoragePath("collisionTimeouts.json"));
+        o << std::setw(4) << records << std::endl;
+    }
+
+    void CollisionDetector::checkpointItemPair(const ItemIndexType i, const ItemIndexType j, bool modified)
+    {
+        if (not checkpointEnabled or pairDeferred(i, j))
+            return;
+        json infos = json::array();
+        for (const auto& p : myCollisionInfos[i])
+        {
+            if (p.first == j)
+                infos.push_back(p.second);
+        }
+        json record = {{"pair", {i, j}}, {"collisionInfos", infos}};
+        if (modified)
+        {
+            // a new shape version never overwrites the version named by a record which has been flushed
+            const size_t version = myCheckpointShapeVersion++;
+            for (const auto k : {i, j})
+            {
+                auto f = checkpointShapePath(k, version);
+                auto f_tmp = fs::path(f).replace_extension(".tmp.bbrep"); // binary brep is selected by suffix
+                OccUtils::writeBrep(item(k), f_tmp.string());
+                fs::rename(f_tmp, f);
+            }
+            record["modifiedItems"] = {i, j};
+            record["shapeVersion"] = version;
+        }
+        // the record is appended after modified shapes have been saved, while item locks are still held,
+        // so records of the same item are in the order of its shape versions
+        dataStorage().appendRecord(myCheckpointFile, record);
+        myCheckpointCount++;
+    }
+
+    fs::path CollisionDetector::checkpointShapePath(const ItemIndexType k, const size_t version) const
+    {
+        return fs::path(myCheckpointShapeFolder) /
+               ("item_" + std::to_string(k) + "_v" + std::to_string(version) + ".bbrep");
+    }
+
+    /**
+     * restore myCollisionInfos, myAdjacencyMatrix and modified shapes from the checkpoint log,
+     * buffered records survive a crash as a prefix of the log, so a shape is restored from the version
+     * named by its last surviving record, which contains no imprint from a pair whose record was lost.
+     * Other shape versions, superseded or written for lost records, are removed.
+     */
+    std::vector<std::vector<ItemIndexType>> CollisionDetector::restoreCheckpoint()
+    {
+        std::vector<std::vector<ItemIndexType>> completed;
+        if (not checkpointEnabled)
+            return completed;
+
+        std::map<ItemIndexType, size_t> modifiedItems; // item index -> shape version
+        auto records = dataStorage().readRecords(myCheckpointFile);
+        for (const auto& r : records)
+        {
+            const ItemIndexType i = r["pair"][0];
+            const ItemIndexType j = r["pair"][1];
+            for (const auto& jinfo : r["collisionInfos"])
+            {
+                CollisionInfo info = jinfo.get<CollisionInfo>();
+                myCollisionInfos[i].push_back(std::make_pair(j, info));
+                CollisionInfo info_j = {j, i, info.value, info.type};
+                myCollisionInfos[j].push_back(std::make_pair(i, info_j));
+                if (info.type == CollisionType::FaceContact)
+                {
+                    myAdjacencyMatrix.insertAt(i, j, true);
+                    myAdjacencyMatrix.insertAt(j, i, true);
+                }
+            }
+            if (r.contains("modifiedItems"))
+            {
+                const size_t version = r["shapeVersion"];
+                for (const auto& k : r["modifiedItems"])
+                    modifiedItems[k.get<ItemIndexType>()] = version;
+                myCheckpointShapeVersion = std::max<size_t>(myCheckpointShapeVersion, version + 1);
+            }
+            completed.push_back({i, j});
+        }
+
+        std::set<fs::path> restoredFiles;
+        for (const auto& [k, version] : modifiedItems)
+        {
+            auto f = checkpointShapePath(k, version);
+            if (fs::exists(f))
+                setItem(k, OccUtils::readBrep(f.string())); // also update boundbox and geometry property
+            else
+                LOG_F(ERROR, "modified shape for item #%lu is not found in checkpoint shape folder", k);
+            restoredFiles.insert(f);
+        }
+        if (fs::exists(myCheckpointShapeFolder))
+        {
+            std::vector<fs::path> staleFiles;
+            for (const auto& e : fs::directory_iterator(myCheckpointShapeFolder))
+            {
+                if (not restoredFiles.count(e.path()))
+                    staleFiles.push_back(e.path());
+            }
+            for (const auto& f : staleFiles)
+                fs::remove(f);
+        }
+        myCheckpointCount = completed.size();
+        LOG_F(INFO, "%lu item pairs and %lu modified items are restored from checkpoint", completed.size(),
+              modifiedItems.size());
+        return completed;
+    }
+
     void CollisionDetector::dealGeneralFuseException(const std::vector<TopoDS_Shape> twoShapes,
                                                      const std::vector<ItemIndexType> itemIndices)
     {
@@ -442,6 +739,7 @@ namespace Geom
     CollisionType CollisionDetector::solveErrorByDistanceCheck(const ItemIndexType i, const ItemIndexType j)
     {
         CollisionType ctype = CollisionType::Error;
+        TraceSpan span("distance", "occt", i, j);
         auto dist = OccUtils::distance(item(i), item(j));
         if (dist > 0)
         {
@@ -539,14 +837,9 @@ namespace Geom
     size_t CollisionDetector::shapeMatch(Standard_Real volume, const std::vector<TopoDS_Shape> shapes,
                                          const std::vector<Standard_Real> vols)
     {
-        size_t matched_index = 0;
-        for (size_t i = 0; i < shapes.size(); i++)
-        {
-            // TODO:  should also compare boundbox of the input shapes to double confirm the matching
-            if (OccUtils::floatEqual(volume, vols[i], 0.1)) // 0.1 should be replaced by parameter
-                matched_index = i;
-        }
-        return matched_index;
+        // TODO:  should also compare boundbox of the input shapes to double confirm the matching
+        // 0.1 should be replaced by parameter
+        return PropertyKernels::lastEqual(volume, vols.data(), std::min(shapes.size(), vols.size()), 0.1);
     }
 
     // consisder move to GeometryProcessor class
@@ -683,8 +976,8 @@ namespace Geom
             // remove the smaller, or keep the one with more contactCount
             if (ctype == CollisionType::Enclosure)
             {
-                auto vol_i = (*myGeometryProperties)[i].volume;
-                auto vol_j = (*myGeometryProperties)[j].volume;
+                auto vol_i = myGeometryPropertyStore->volume(i);
+                auto vol_j = myGeometryPropertyStore->volume(j);
                 auto k = (vol_i < vol_j) ? i : j;
                 if (not itemSuppressed(k))
                 {
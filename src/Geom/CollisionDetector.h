@@ -11,11 +11,83 @@
 #include "OccUtils.h"
 #include "PPP/SparseMatrix.h"
 
+#include <array>
+#include <numeric>
+
+#include "tbb/task_arena.h"
+#include "tbb/task_group.h"
+
 
 namespace Geom
 {
     using namespace PPP;
 
+    /// \ingroup Geom
+    /**
+     * wall time in seconds of the phases of collision detection of an item pair, summed over tolerance retries
+     * intersection and building are the 2 phases of `BRepAlgoAPI_BuilderAlgo`, the rest are in calcCollisionType()
+     * */
+    struct CollisionPhaseTimes
+    {
+        enum Phase
+        {
+            Intersection = 0, ///< BOPAlgo_PaveFiller, interference of sub-shapes
+            Building,         ///< split and build result solids from the filler
+            History,          ///< history queries like HasModified()
+            Volume,           ///< volume integral of the original and result solids
+            Area,             ///< area and perimeter integral in contact type check
+            Distance,         ///< distance check for clearance and error solving
+            PhaseCount
+        };
+        static constexpr std::array<const char*, PhaseCount> phaseNames = {
+            "intersection", "building", "history", "volume", "area", "distance"};
+
+        std::array<double, PhaseCount> seconds = {};
+
+        double total() const
+        {
+            return std::accumulate(seconds.cbegin(), seconds.cend(), 0.0);
+        }
+        json toJson() const
+        {
+            json j;
+            for (size_t p = 0; p < PhaseCount; p++)
+                j[phaseNames[p]] = seconds[p];
+            return j;
+        }
+    };
+
+    /// RAII timer, add the elapsed wall time to a phase, do nothing if `times` is nullptr (timing disabled)
+    class PhaseTimer
+    {
+    private:
+        CollisionPhaseTimes* myTimes;
+        CollisionPhaseTimes::Phase myPhase;
+        std::chrono::steady_clock::time_point myStart;
+
+    public:
+        PhaseTimer(CollisionPhaseTimes* times, CollisionPhaseTimes::Phase phase)
+                : myTimes(times)
+                , myPhase(phase)
+        {
+            if (myTimes)
+                myStart = std::chrono::steady_clock::now();
+        }
+        PhaseTimer(const PhaseTimer&) = delete;
+        ~PhaseTimer()
+        {
+            stop();
+        }
+        /// stop before the end of scope, only the first call counts
+        void stop()
+        {
+            if (myTimes)
+                myTimes->seconds[myPhase] +=
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - myStart).count();
+            myTimes = nullptr;
+        }
+    };
+
     /// \ingroup Geom
     /**
      * collision and proximity detection by general fusion boolean operation
@@ -33,17 +105,48 @@ namespace Geom
         bool suppressFloating;
         bool suppressErroneous;
 
-        /// ".brep" ".step" file formats are supported, but step write has lots of print
+        /// ".brep", ".bbrep" (OCCT binary brep) ".step" file formats are supported, but step write has lots of print
         std::string myDumpFileType = ".brep";
 
         std::shared_ptr<VectorType<Bnd_Box>> myShapeBoundBoxes;
+        /// packed copy of `myShapeBoundBoxes`, for the broad-phase test of one item against many
+        std::shared_ptr<BoundBoxArray> myPackedBoundBoxes;
         std::shared_ptr<VectorType<GeometryProperty>> myGeometryProperties;
+        /// volume column for pair checks, kept in sync with `myGeometryProperties` by setItem()
+        std::shared_ptr<GeometryPropertyStore> myGeometryPropertyStore;
         std::shared_ptr<VectorType<Bnd_OBB>> myShapeOrientedBoundBoxes;
+        /// packed copy of `myShapeOrientedBoundBoxes` for the SAT test with clearance, null if OBB is not available
+        std::shared_ptr<OrientedBoundBoxArray> myPackedOrientedBoundBoxes;
+
+        /// append-only log of completed item pairs, in data storage folder, to resume an interrupted run
+        bool checkpointEnabled;
+        std::string myCheckpointFile;
+        /// folder of modified shapes, saved in OCCT binary brep format, named by item index and shape version
+        std::string myCheckpointShapeFolder;
+        std::atomic<size_t> myCheckpointCount{0};
+        /// each modified pair saves its shapes as a new version, named in its checkpoint record
+        std::atomic<size_t> myCheckpointShapeVersion{0};
 
         AdjacencyMatrixType myAdjacencyMatrix;
         SparseMatrix<CollisionInfo> myCollisionInfos;
         std::unordered_map<CollisionType, ItemIndexType> myCollisionSummary;
 
+        /// per-pair phase timing, aggregated per collision type, written into `collisionPhaseTimes.json`
+        bool phaseTiming;
+        std::mutex myPhaseTimeMutex;
+        std::map<CollisionType, std::vector<std::pair<std::array<ItemIndexType, 2>, CollisionPhaseTimes>>>
+            myPhaseTimes;
+
+        /// wall time budget in seconds of an item pair, zero for unlimited,
+        /// a timed-out pair is deferred, so its item locks are released for other workers
+        double pairTimeBudget;
+        /// deferred pairs are retried in prepareOutput() by this larger budget and a relaxed tolerance, 0 to disable
+        double timeoutRetryFactor;
+        /// try 10 times bigger fuzzy tolerance first, set during the retry of deferred pairs only
+        bool myRelaxedTolerance = false;
+        std::mutex myDeferredMutex;
+        std::vector<std::array<ItemIndexType, 2>> myDeferredPairs;
+
     public:
         CollisionDetector()
         {
@@ -51,7 +154,8 @@ namespace Geom
             myCharacteristics["coupled"] = true;
             myCharacteristics["indexPattern"] = IndexPattern::FilteredMatrix;
             myCharacteristics["indexDimension"] = 2;
-            myCharacteristics["requiredProperties"] = {"myShapeBoundBoxes", "myGeometryProperties"};
+            myCharacteristics["requiredProperties"] = {"myShapeBoundBoxes", "myGeometryProperties",
+                                                       "myGeometryPropertyStore"};
             myCharacteristics["producedProperties"] = {"myCollisionInfos"};
         }
         ~CollisionDetector() = default;
@@ -66,17 +170,45 @@ namespace Geom
             clearanceThreshold = parameterValue<Standard_Real>("clearanceThreshold", 0.5);
             suppressFloating = parameter("suppressFloating", false);
             suppressErroneous = parameter("suppressErroneous", true);
+            myDumpFileType = parameterValue<std::string>("dumpFileType", myDumpFileType);
 
-            myShapeBoundBoxes = myInputData->get<VectorType<Bnd_Box>>("myShapeBoundBoxes");
+            myShapeBoundBoxes = myInputData->get(PropertyKeys::ShapeBoundBoxes);
+            if (myInputData->contains(PropertyKeys::PackedBoundBoxes))
+                myPackedBoundBoxes = myInputData->get(PropertyKeys::PackedBoundBoxes);
+            else // bound boxes not built by BoundBoxBuilder
+                myPackedBoundBoxes = std::make_shared<BoundBoxArray>(*myShapeBoundBoxes);
 
-            if (myInputData->contains("myShapeOrientedBoundBoxes"))
-                myShapeOrientedBoundBoxes = myInputData->get<VectorType<Bnd_OBB>>("myShapeOrientedBoundBoxes");
+            if (myInputData->contains(PropertyKeys::ShapeOrientedBoundBoxes))
+            {
+                myShapeOrientedBoundBoxes = myInputData->get(PropertyKeys::ShapeOrientedBoundBoxes);
+                if (myInputData->contains(PropertyKeys::PackedOrientedBoundBoxes))
+                    myPackedOrientedBoundBoxes = myInputData->get(PropertyKeys::PackedOrientedBoundBoxes);
+                else
+                    myPackedOrientedBoundBoxes = std::make_shared<OrientedBoundBoxArray>(*myShapeOrientedBoundBoxes);
+            }
 
-            myGeometryProperties = myInputData->get<VectorType<GeometryProperty>>("myGeometryProperties");
+            myGeometryProperties = myInputData->get(PropertyKeys::GeometryProperties);
+            myGeometryPropertyStore = myInputData->get(PropertyKeys::PropertyStore);
             // resize() avoid reallocate memeroy and invalidate iterator/memory address
             myAdjacencyMatrix.resize(myInputData->itemCount());
             myCollisionInfos.resize(myInputData->itemCount());
 
+            phaseTiming = parameterValue<bool>("phaseTiming", false);
+            myPhaseTimes.clear();
+            pairTimeBudget = parameterValue<double>("pairTimeBudget", 0.0);
+            timeoutRetryFactor = parameterValue<double>("timeoutRetryFactor", 4.0);
+            myDeferredPairs.clear();
+
+            // off by default, records are written periodically rather than per pair, to limit the cost
+            checkpointEnabled = parameterValue<bool>("checkpoint", false);
+            myCheckpointFile = parameterValue<std::string>("checkpointFile", "myCollisionInfos_checkpoint.jsonl");
+            if (checkpointEnabled)
+                dataStorage().setRecordFlushPolicy(parameterValue<size_t>("checkpointRecordCount", 1000),
+                                                   parameterValue<double>("checkpointInterval", 10.0));
+            myCheckpointShapeFolder = dataStorage().getFullPath("checkpoint_shapes");
+            if (checkpointEnabled and not fs::exists(myCheckpointShapeFolder))
+                fs::create_directory(myCheckpointShapeFolder);
+
             // this may be not the best place to call external progressor,
             // but it is the only place, if we want a progressor for a specific time-consuming processor
             if (itemCount() > 1000)
@@ -87,6 +219,10 @@ namespace Geom
 
         virtual void prepareOutput() override
         {
+            processDeferredPairs(); // before the adjacency matrix is moved out
+            if (checkpointEnabled)
+                dataStorage().flushRecords();
+
             auto mat_file_name = dataStoragePath("myAdjacencyMatrix.mm");
             myAdjacencyMatrix.writeMatrixMarketFile(mat_file_name);
             myOutputData->emplace("myAdjacencyMatrix", std::move(myAdjacencyMatrix));
@@ -98,6 +234,8 @@ namespace Geom
             auto file_name = dataStoragePath(parameter<std::string>("output", "myCollisionInfos.json"));
             myCollisionInfos.toJson(file_name);
             checkCollisionResolution();
+            if (phaseTiming)
+                reportPhaseTimes(dataStoragePath("collisionPhaseTimes.json"));
         }
 
         virtual bool isCoupledPair(const ItemIndexType i, const ItemIndexType j) override final
@@ -105,6 +243,15 @@ namespace Geom
             return detectBoundBoxOverlapping(i, j, clearanceThreshold); // capture item pair near each other
         }
 
+        /// the same as isCoupledPair(), but all items j > i are tested by the packed AABB kernel first
+        virtual std::vector<ItemIndexType> coupledItems(const ItemIndexType i) override final
+        {
+            auto ids = myPackedBoundBoxes->overlappedItems(i, clearanceThreshold);
+            if (myPackedOrientedBoundBoxes) // narrow down AABB candidates by OBB, in a batch
+                myPackedOrientedBoundBoxes->removeSeparated(i, ids, clearanceThreshold);
+            return ids;
+        }
+
         /// turn off OCCT internal multiple threading, PPP will schedule the job using multithreading
         virtual void processItemPair(const ItemIndexType i, const ItemIndexType j) override
         {
@@ -121,14 +268,29 @@ namespace Geom
                 if (detectBoundBoxOverlapping(i, j, clearanceThreshold))
                     calcClearance(i, j);
             }
+            checkpointItemPair(i, j, false);
+        }
+
+        /// item pairs have been appended to the checkpoint log once completed, write out the buffered records
+        virtual void checkpoint() override
+        {
+            if (checkpointEnabled)
+            {
+                dataStorage().flushRecords();
+                LOG_F(WARNING, "%lu completed item pairs have been saved into checkpoint file `%s`",
+                      myCheckpointCount.load(), myCheckpointFile.c_str());
+            }
         }
 
+        virtual std::vector<std::vector<ItemIndexType>> restoreCheckpoint() override;
+
     public:
         /// @{ static method group for unit test
         /** using fusion volume to detect collision type between 2 solids, called after generalFuse() */
         static CollisionType calcCollisionType(std::shared_ptr<BRepAlgoAPI_BuilderAlgo> mkGFA,
                                                std::vector<Standard_Real> origVols = {},
-                                               std::vector<ItemIndexType> ij = {});
+                                               std::vector<ItemIndexType> ij = {},
+                                               CollisionPhaseTimes* times = nullptr);
         /** collision detection by boolean fragments, including contact, enclosure, interference */
         static bool hasCollision(const TopoDS_Shape& s, const TopoDS_Shape& s2, double theTolerance = 0.0);
         /** using fusion volume to detect collision type */
@@ -149,20 +311,42 @@ namespace Geom
 
             // update other properties
             (*myGeometryProperties)[index] = OccUtils::geometryProperty(newShape);
+            myGeometryPropertyStore->set(index, (*myGeometryProperties)[index]);
             (*myShapeBoundBoxes)[index] = OccUtils::calcBndBox(newShape);
-            if (myInputData->contains("myShapeOrientedBoundBoxes"))
+            myPackedBoundBoxes->set(index, (*myShapeBoundBoxes)[index]);
+            if (myInputData->contains(PropertyKeys::ShapeOrientedBoundBoxes)) // typed key, no string hashing
+            {
                 (*myShapeOrientedBoundBoxes)[index] = OccUtils::calcBndBox(newShape);
+                myPackedOrientedBoundBoxes->set(index, (*myShapeOrientedBoundBoxes)[index]);
+            }
         }
 
         bool detectCollision(const ItemIndexType i, const ItemIndexType j, bool internalMultiThreading = true,
                              bool imprinting = false);
         CollisionType calcClearance(const ItemIndexType i, const ItemIndexType j);
+        /// append collision infos of the completed pair and the modified shapes into checkpoint data,
+        /// a deferred (timed-out) pair is skipped, so it will be processed again if resumed
+        void checkpointItemPair(const ItemIndexType i, const ItemIndexType j, bool modified);
+        /// file path of the saved shape of item `k`, `version` is unique for each modified pair
+        fs::path checkpointShapePath(const ItemIndexType k, const size_t version) const;
+        /// thread-safe, a pair is deferred if it exceeded `pairTimeBudget`
+        bool pairDeferred(const ItemIndexType i, const ItemIndexType j);
+        /** retry deferred pairs in parallel by `processItemPair()` with a larger time budget and a relaxed tolerance,
+         * in rounds of pairs sharing no item,
+         * a pair timed out again is marked as CollisionType::Unknown, reasons are written into
+         * `collisionTimeouts.json` */
+        void processDeferredPairs();
         bool detectBoundBoxOverlapping(const ItemIndexType i, const ItemIndexType j, double clearance);
 
     private:
         void dealGeneralFuseException(const std::vector<TopoDS_Shape> twoShapes,
                                       const std::vector<ItemIndexType> itemIndices);
         CollisionType solveErrorByDistanceCheck(const ItemIndexType i, const ItemIndexType j);
+        /// thread-safe, called at the end of detectCollision() if `phaseTiming` is enabled
+        void recordPhaseTimes(const ItemIndexType i, const ItemIndexType j, const CollisionType ctype,
+                              const CollisionPhaseTimes& times);
+        /// log the phase time fraction per collision type, write the summary and per-pair records into json file
+        void reportPhaseTimes(const std::string& file_name) const;
 
         /// if bool fragments result in more than 2 solids, there is interference
         /// if the interference is small (volume threshold), substract it from the bigger volume
@@ -7,6 +7,7 @@
 #include "../third-party/loguru/loguru.cpp"
 #endif
 
+#include "PPP/MemoryMonitor.h"
 #include "PPP/Utilities.h"
 
 #include "BoundBoxBuilder.h"
@@ -68,6 +69,13 @@ namespace Geom
         // GeometryDecomposer::init();
         // GeometryFixer::init();
         VLOG_F(LOGLEVEL_DEBUG, "Processor types in geom module has been registered \n");
+
+        /// OCCT view of the process memory, heap usage includes OCCT memory manager if `MMGT_OPT=0`
+        MemoryMonitor::addProbe("occtHeapUsage", []() {
+            OSD_MemInfo memInfo(false);
+            memInfo.Update();
+            return double(memInfo.ValueMiB(OSD_MemInfo::MemHeapUsage));
+        });
     }
 
 
@@ -0,0 +1,215 @@
+/// generate parameterised synthetic assembly for scaling benchmark, see `src/python/geomBenchmark.py`
+
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include <BRepAlgoAPI_Cut.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
+#include <BRepPrimAPI_MakeSphere.hxx>
+#include <BRepTools.hxx>
+#include <BRep_Builder.hxx>
+#include <TopoDS_Compound.hxx>
+#include <TopoDS_Shape.hxx>
+#include <gp_Ax2.hxx>
+#include <gp_Pnt.hxx>
+
+#include "nlohmann/json.hpp"
+
+/// shorten the name for convenience
+using json = nlohmann::json;
+
+/**
+ * N x M x K grid of cells with the edge length `size`, one solid per cell.
+ * The category of each cell decides the relation with its neighbours in +x, +y, +z directions:
+ * + contact: cube fills the cell, sharing faces with neighbours
+ * + interference: cube is enlarged by `overlap * size`, interfering with neighbours
+ * + clearance: cube is shrunk by `gap * size`, a small gap to neighbours
+ * + the rest (1 - sum of the 3 fractions): cube of the half size, far from neighbours
+ * A `curved` fraction of cells are replaced by spheres or cylinders of the same category.
+ * `shells` nested hollow boxes enclose the whole grid, to simulate the decoration/protection shell,
+ * whose bound box overlaps with all the parts inside.
+ */
+struct AssemblyParameters
+{
+    int nx = 4;
+    int ny = 4;
+    int nz = 4;
+    double size = 10.0;
+    double contact = 0.6;
+    double interference = 0.1;
+    double clearance = 0.1;
+    double curved = 0.0;
+    int shells = 0;
+    double overlap = 0.05;
+    double gap = 0.01;
+    unsigned int seed = 0;
+};
+
+enum class CellCategory
+{
+    Contact,
+    Interference,
+    Clearance,
+    Separated
+};
+
+TopoDS_Shape makeCellSolid(const gp_Pnt& origin, const double length, const bool curved, const bool useSphere)
+{
+    if (not curved)
+        return BRepPrimAPI_MakeBox(origin, length, length, length).Solid();
+    const double r = length * 0.5;
+    if (useSphere)
+        return BRepPrimAPI_MakeSphere(gp_Pnt(origin.X() + r, origin.Y() + r, origin.Z() + r), r).Solid();
+    return BRepPrimAPI_MakeCylinder(gp_Ax2(gp_Pnt(origin.X() + r, origin.Y() + r, origin.Z()), gp::DZ()), r, length)
+        .Solid();
+}
+
+/// hollow box between the inner and outer box, as a closed shell with thickness
+TopoDS_Shape makeHollowBox(const gp_Pnt& innerMin, const gp_Pnt& innerMax, const double thickness)
+{
+    const gp_Pnt outerMin(innerMin.X() - thickness, innerMin.Y() - thickness, innerMin.Z() - thickness);
+    const gp_Pnt outerMax(innerMax.X() + thickness, innerMax.Y() + thickness, innerMax.Z() + thickness);
+    TopoDS_Shape outer = BRepPrimAPI_MakeBox(outerMin, outerMax).Solid();
+    TopoDS_Shape inner = BRepPrimAPI_MakeBox(innerMin, innerMax).Solid();
+    return BRepAlgoAPI_Cut(outer, inner).Shape();
+}
+
+/// write the compound of all solids into brep file, return the summary
+json generateAssembly(const AssemblyParameters& p, const std::string& filename)
+{
+    if (p.contact + p.interference + p.clearance > 1.0)
+        throw std::invalid_argument("sum of contact, interference and clearance fractions must not exceed 1");
+
+    std::mt19937 gen(p.seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const double L = p.size;
+
+    BRep_Builder builder;
+    TopoDS_Compound compound;
+    builder.MakeCompound(compound);
+
+    std::size_t categoryCounts[4] = {0, 0, 0, 0}; // indexed by CellCategory
+    std::size_t curvedCount = 0;
+    for (int k = 0; k < p.nz; k++)
+    {
+        for (int j = 0; j < p.ny; j++)
+        {
+            for (int i = 0; i < p.nx; i++)
+            {
+                const double r = uniform(gen);
+                CellCategory c = CellCategory::Separated;
+                double length = L * 0.5;
+                if (r < p.contact)
+                {
+                    c = CellCategory::Contact;
+                    length = L;
+                }
+                else if (r < p.contact + p.interference)
+                {
+                    c = CellCategory::Interference;
+                    length = L * (1.0 + p.overlap);
+                }
+                else if (r < p.contact + p.interference + p.clearance)
+                {
+                    c = CellCategory::Clearance;
+                    length = L * (1.0 - p.gap);
+                }
+                categoryCounts[static_cast<int>(c)]++;
+
+                const bool curved = uniform(gen) < p.curved;
+                curvedCount += curved;
+                const gp_Pnt origin(i * L, j * L, k * L);
+                builder.Add(compound, makeCellSolid(origin, length, curved, curvedCount % 2));
+            }
+        }
+    }
+
+    // the outmost cell may be enlarged by interference, shells must not touch the grid
+    const double margin = L * (0.5 + p.overlap);
+    const double thickness = L * 0.2;
+    for (int s = 0; s < p.shells; s++)
+    {
+        const double offset = margin + s * (thickness + L * 0.3);
+        const gp_Pnt innerMin(-offset, -offset, -offset);
+        const gp_Pnt innerMax(p.nx * L + offset, p.ny * L + offset, p.nz * L + offset);
+        builder.Add(compound, makeHollowBox(innerMin, innerMax, thickness));
+    }
+
+    BRepTools::Write(compound, filename.c_str());
+
+    json summary;
+    summary["fileName"] = filename;
+    summary["solidCount"] = p.nx * p.ny * p.nz + p.shells;
+    summary["grid"] = {p.nx, p.ny, p.nz};
+    summary["size"] = p.size;
+    summary["fractions"] = {{"contact", p.contact},
+                            {"interference", p.interference},
+                            {"clearance", p.clearance},
+                            {"curved", p.curved}};
+    summary["counts"] = {{"contact", categoryCounts[static_cast<int>(CellCategory::Contact)]},
+                         {"interference", categoryCounts[static_cast<int>(CellCategory::Interference)]},
+                         {"clearance", categoryCounts[static_cast<int>(CellCategory::Clearance)]},
+                         {"separated", categoryCounts[static_cast<int>(CellCategory::Separated)]},
+                         {"curved", curvedCount}};
+    summary["shells"] = p.shells;
+    summary["seed"] = p.seed;
+    return summary;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 5)
+    {
+        std::cout << "Usage: pppAssemblyGenerator output.brep nx ny nz [key=value ...]" << std::endl
+                  << "keys: size, contact, interference, clearance, curved, shells, overlap, gap, seed" << std::endl
+                  << "summary is printed to stdout in json format" << std::endl;
+        return 1;
+    }
+
+    AssemblyParameters p;
+    const std::string filename = argv[1];
+    p.nx = std::stoi(argv[2]);
+    p.ny = std::stoi(argv[3]);
+    p.nz = std::stoi(argv[4]);
+    for (int a = 5; a < argc; a++)
+    {
+        const std::string arg = argv[a];
+        const auto pos = arg.find('=');
+        if (pos == std::string::npos)
+        {
+            std::cerr << "argument must be in the form of key=value: " << arg << std::endl;
+            return 1;
+        }
+        const std::string key = arg.substr(0, pos);
+        const std::string value = arg.substr(pos + 1);
+        if (key == "size")
+            p.size = std::stod(value);
+        else if (key == "contact")
+            p.contact = std::stod(value);
+        else if (key == "interference")
+            p.interference = std::stod(value);
+        else if (key == "clearance")
+            p.clearance = std::stod(value);
+        else if (key == "curved")
+            p.curved = std::stod(value);
+        else if (key == "shells")
+            p.shells = std::stoi(value);
+        else if (key == "overlap")
+            p.overlap = std::stod(value);
+        else if (key == "gap")
+            p.gap = std::stod(value);
+        else if (key == "seed")
+            p.seed = static_cast<unsigned int>(std::stoul(value));
+        else
+        {
+            std::cerr << "unknown key: " << key << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << generateAssembly(p, filename).dump(4) << std::endl;
+    return 0;
+}
@@ -171,6 +171,24 @@ TEST_CASE("OccUtilsTest")
 
         TopoDS_Shape box3 = BRepPrimAPI_MakeBox(o, gp_Pnt(-L, -L, -L)).Shape();
         REQUIRE(CollisionDetector::detectCollisionType(box, box3, vols) == CollisionType::VertexContact);
+
+        // explicit PaveFiller gives the same result, the filler must be kept alive for history queries
+        CollisionPhaseTimes times;
+        mkGFA = std::make_shared<BRepAlgoAPI_BuilderAlgo>();
+        res = generalFuseInPhases({box, box1}, 0.0, mkGFA, times.seconds[CollisionPhaseTimes::Intersection],
+                                  times.seconds[CollisionPhaseTimes::Building]);
+        REQUIRE(res.size() == 2);
+        ctype = CollisionDetector::calcCollisionType(mkGFA, {}, {}, &times);
+        REQUIRE(ctype == CollisionType::FaceContact);
+        REQUIRE(times.seconds[CollisionPhaseTimes::Building] > 0);
+        REQUIRE(times.seconds[CollisionPhaseTimes::Volume] > 0);
+        REQUIRE(times.seconds[CollisionPhaseTimes::Area] > 0);
+        REQUIRE(times.seconds[CollisionPhaseTimes::Distance] == 0);
+
+        // a generous time budget does not break the boolean operation
+        mkGFA = std::make_shared<BRepAlgoAPI_BuilderAlgo>();
+        res = generalFuse({box, box2}, 0.0, mkGFA, 60.0);
+        REQUIRE(CollisionDetector::calcCollisionType(mkGFA) == CollisionType::EdgeContact);
     }
 
     SECTION("curved_surface_contact_tests")
@@ -220,7 +238,13 @@ TEST_CASE("OccUtilsTest")
         float R = 10;
         auto s = BRepPrimAPI_MakeSphere(R).Shape();
         auto s2 = BRepBuilderAPI_Copy(s).Shape();
-        REQUIRE(s.HashCode(ItemHashMax) != s2.HashCode(ItemHashMax));
+        REQUIRE(shapeHash(s) != shapeHash(s2));
+        REQUIRE(shapeHash(s) == shapeHash(s.Reversed())); // same as `IsSame()`
+
+        gp_Trsf t;
+        t.SetTranslation(gp_Vec(2 * R, 0, 0));
+        auto s3 = s.Moved(TopLoc_Location(t)); // shared TShape, but diff location
+        REQUIRE(shapeHash(s) != shapeHash(s3));
     }
 
     SECTION("test_geometry_tolerance")
@@ -230,6 +254,150 @@ TEST_CASE("OccUtilsTest")
 }
 
 
+TEST_CASE("GeometryPropertyStoreTest")
+{
+    GeometryPropertyStore store;
+    const ItemIndexType N = 101; // not multiple of SIMD lanes, to test the loop tail
+    store.resize(N);
+    for (ItemIndexType i = 0; i < N; i++)
+    {
+        GeometryProperty p;
+        p.volume = double(i);
+        p.area = (i % 2) ? 10.0 * i : 1.0 * i;
+        p.perimeter = 0;
+        p.tolerance = 1e-7;
+        p.solidCount = 1;
+        p.faceCount = 6;
+        p.edgeCount = 12;
+        p.centerOfMass = {0.0, 1.0, 2.0};
+        store.set(i, p);
+    }
+    REQUIRE(store.property(3).area == Approx(30.0));
+    REQUIRE(store.property(3).centerOfMass[2] == Approx(2.0));
+
+    const VectorType<ItemIndexType> smallIds = {0, 1};
+    REQUIRE(store.selectVolumeBelow(1.5) == smallIds);
+    const VectorType<ItemIndexType> bigIds = {99, 100};
+    REQUIRE(store.selectVolumeAbove(98.5) == bigIds);
+    REQUIRE(store.selectVolumeInRange(10, 12).size() == 3);
+    REQUIRE(store.selectAreaVolumeRatioInRange(5.0, 20.0).size() == N / 2);
+
+    auto range = store.volumeRange(1.5, 99.5);
+    REQUIRE(range.first == Approx(2.0));
+    REQUIRE(range.second == Approx(99.0));
+    range = store.volumeRange(200, 300); // empty
+    REQUIRE(range.first > range.second);
+
+    std::vector<double> vols = {10.0, 99.0, 100.5, 3.0};
+    REQUIRE(PropertyKernels::lastEqual(100.0, vols.data(), vols.size(), 0.1) == 2);
+    REQUIRE(PropertyKernels::lastEqual(1000.0, vols.data(), vols.size(), 0.1) == 0); // no match
+}
+
+TEST_CASE("BoundBoxArrayTest")
+{
+    const ItemIndexType N = 37; // not multiple of SIMD lanes, to test the loop tail
+    VectorType<Bnd_Box> boxes(N);
+    for (ItemIndexType i = 0; i < N; i++)
+    {
+        if (i % 10 == 9)
+            continue; // void box
+        double x = 1.0 * i;
+        boxes[i].Update(x, 0.1 * (i % 3), 0, x + 1.0, 1.0, 1.0);
+    }
+    BoundBoxArray packed(boxes);
+    REQUIRE(packed.size() == N);
+
+    for (const double gap : {0.0, 0.5, -0.1})
+    {
+        for (ItemIndexType i = 0; i < N; i++)
+        {
+            const auto ids = packed.overlappedItems(i, gap);
+            std::set<ItemIndexType> idSet(ids.begin(), ids.end());
+            for (ItemIndexType j = i + 1; j < N; j++)
+            {
+                bool expected = false;
+                if (not(boxes[i].IsVoid() or boxes[j].IsVoid()))
+                    expected = OccUtils::isBndBoxOverlapped(boxes[i], boxes[j], gap);
+                REQUIRE(packed.overlapped(i, j, gap) == expected);
+                REQUIRE(idSet.count(j) == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("BoundBoxTreeTest")
+{
+    const ItemIndexType N = 200; // a grid of 1mm cubes with 1mm spacing, 10 x 20 x 1
+    VectorType<Bnd_Box> boxes(N);
+    for (ItemIndexType i = 0; i < N; i++)
+    {
+        if (i % 50 == 7)
+            continue; // void box
+        const double x = 2.0 * (i % 10), y = 2.0 * (i / 10);
+        boxes[i].Update(x, y, 0, x + 1.0, y + 1.0, 1.0);
+    }
+    BoundBoxArray packed(boxes);
+    BoundBoxTree tree(packed);
+    REQUIRE(tree.nodeCount() > 1);
+
+    const double region[6] = {1.5, 1.5, -1, 6.5, 5.5, 2}; // x in [1.5, 6.5], y in [1.5, 5.5]
+    Bnd_Box regionBox;
+    regionBox.Update(region[0], region[1], region[2], region[3], region[4], region[5]);
+    for (const auto type : {BoundBoxQueryType::Coincident, BoundBoxQueryType::Intersect, BoundBoxQueryType::Contain})
+    {
+        auto found = tree.query(region, type, 0.0);
+        for (ItemIndexType i = 0; i < N; i++)
+        {
+            double b[6];
+            packed.get(i, b);
+            bool inside = b[0] >= region[0] and b[1] >= region[1] and b[3] <= region[3] and b[4] <= region[4];
+            bool expected = false;
+            if (type == BoundBoxQueryType::Intersect)
+                expected = not boxes[i].IsVoid() and OccUtils::isBndBoxOverlapped(boxes[i], regionBox, 0.0);
+            else if (type == BoundBoxQueryType::Contain)
+                expected = not boxes[i].IsVoid() and inside;
+            REQUIRE(std::binary_search(found.begin(), found.end(), i) == expected); // Coincident: none
+        }
+    }
+
+    // the exact box of item 12 is coincident with item 12 only
+    double box[6];
+    packed.get(12, box);
+    const VectorType<ItemIndexType> coincident = {12};
+    REQUIRE(tree.query(box, BoundBoxQueryType::Coincident, 1e-2) == coincident);
+}
+
+#if OCC_VERSION_HEX >= 0x070300
+TEST_CASE("OrientedBoundBoxArrayTest")
+{
+    // unit cubes along x axis with increasing distance, rotated about z axis for odd index
+    const ItemIndexType N = 6;
+    VectorType<Bnd_OBB> boxes(N);
+    for (ItemIndexType i = 0; i < N; i++)
+    {
+        const double angle = (i % 2) ? std::atan(1.0) : 0.0; // 45 degree
+        gp_Dir xDir(std::cos(angle), std::sin(angle), 0), yDir(-std::sin(angle), std::cos(angle), 0), zDir(0, 0, 1);
+        boxes[i] = Bnd_OBB(gp_Pnt(1.9 * i * i, 0, 0), xDir, yDir, zDir, 0.5, 0.5, 0.5);
+    }
+    OrientedBoundBoxArray packed(boxes);
+    for (ItemIndexType i = 0; i < N; i++)
+    {
+        for (ItemIndexType j = 0; j < N; j++)
+        {
+            REQUIRE(packed.overlapped(i, j, 0.0) == not boxes[i].IsOut(boxes[j]));
+        }
+    }
+    // box 0 and box 1: center distance 1.9, half size 0.5 and sqrt(2)/2 along x, gap is about 0.69
+    REQUIRE(not packed.overlapped(0, 1, 0.5));
+    REQUIRE(packed.overlapped(0, 1, 0.8));
+
+    VectorType<ItemIndexType> ids = {1, 2, 3};
+    packed.removeSeparated(0, ids, 0.8);
+    REQUIRE(ids.size() == 1);
+    REQUIRE(ids[0] == 1);
+}
+#endif
+
 TEST_CASE("GeometryImprintTest")
 {
     using namespace Geom::OccUtils;
@@ -326,6 +494,15 @@ TEST_CASE("GeometryImprintTest")
 
         REQUIRE(countSubShapes(readback, TopAbs_FACE) == NumberOfFaces);
         REQUIRE(countSubShapes(readback, TopAbs_COMPSOLID) == 1);
+
+        // OCCT binary brep format, selected by file suffix
+        std::string bf = "_tmp.bbrep";
+        saveShape(compSolid, bf);
+        REQUIRE(fs::exists(bf));
+        const TopoDS_Shape binReadback = OccUtils::loadShape(bf);
+        fs::remove(bf);
+        REQUIRE(countSubShapes(binReadback, TopAbs_FACE) == NumberOfFaces);
+        REQUIRE(countSubShapes(binReadback, TopAbs_COMPSOLID) == 1);
     }
 
     /// boxes in 3D stacking configuration
@@ -2,6 +2,9 @@
 #define PPP_GEOMETRY_DATA_H
 
 
+#include "./BoundBoxArray.h"
+#include "./GeometryPropertyStore.h"
+#include "./OrientedBoundBoxArray.h"
 #include "./GeometryTypes.h"
 #include "PPP/DataObject.h"
 #include "PPP/Logger.h"
@@ -11,6 +14,28 @@ namespace Geom
 {
     using namespace PPP;
 
+    /// \ingroup Geom
+    /**
+     * typed keys of the properties shared by geometry processors, resolved to slot index once,
+     * use `myInputData->get(PropertyKeys::ShapeBoundBoxes)` instead of string key in processors
+     */
+    namespace PropertyKeys
+    {
+        inline const PropertyKey<ItemVectorType> Solids{"mySolids"};
+        inline const PropertyKey<VectorType<ItemHashType>> SolidIDs{"mySolidIDs"};
+        inline const PropertyKey<ItemIndexMapType> ShapeIndices{"myShapeIndices"};
+        inline const PropertyKey<VectorType<ShapeErrorType>> ShapeErrors{"myShapeErrors"};
+        inline const PropertyKey<VectorType<std::string>> ItemNames{"myItemNames"};
+        inline const PropertyKey<VectorType<std::optional<Quantity_Color>>> ItemColors{"myItemColors"};
+        inline const PropertyKey<VectorType<std::optional<Material>>> ItemMaterials{"myItemMaterials"};
+        inline const PropertyKey<VectorType<Bnd_Box>> ShapeBoundBoxes{"myShapeBoundBoxes"};
+        inline const PropertyKey<VectorType<Bnd_OBB>> ShapeOrientedBoundBoxes{"myShapeOrientedBoundBoxes"};
+        inline const PropertyKey<BoundBoxArray> PackedBoundBoxes{"myPackedBoundBoxes"};
+        inline const PropertyKey<OrientedBoundBoxArray> PackedOrientedBoundBoxes{"myPackedOrientedBoundBoxes"};
+        inline const PropertyKey<VectorType<GeometryProperty>> GeometryProperties{"myGeometryProperties"};
+        inline const PropertyKey<GeometryPropertyStore> PropertyStore{"myGeometryPropertyStore"};
+    } // namespace PropertyKeys
+
     /// \ingroup Geom
     /**
      * GeometryData, base class for all geometry data mappable to vtkPolyData
@@ -33,12 +58,12 @@ namespace Geom
 
             if (contains("myShapes"))
             {
-                auto shapes = getConst<ItemContainerType>("myShapes");
+                auto shapes = getConst<ItemVectorType>("myShapes");
                 size = shapes->size();
             }
             else if (contains("mySolids")) // also compared myShapeType
             {
-                auto shapes = getConst<ItemContainerType>("mySolids");
+                auto shapes = getConst<ItemVectorType>("mySolids");
                 size = shapes->size();
             }
             else
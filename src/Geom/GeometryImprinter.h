@@ -49,16 +49,18 @@ namespace Geom
         /// turn off OCCT internal multiple threading, parallel externally
         virtual void processItemPair(const ItemIndexType i, const ItemIndexType j) override final
         {
+            bool modified = false;
             if (detectBoundBoxOverlapping(i, j, toleranceThreshold))
             {
                 if (not(itemSuppressed(i) or itemSuppressed(j)))
-                    detectCollision(i, j, false, true);
+                    modified = detectCollision(i, j, false, true);
             }
             else // boundbox check
             {
                 if (detectBoundBoxOverlapping(i, j, clearanceThreshold))
                     calcClearance(i, j);
             }
+            checkpointItemPair(i, j, modified);
         }
 
     }; // class ending
@@ -3,6 +3,8 @@
 #define PPP_GEOMETRY_PROCESSOR_H
 
 #include "GeometryData.h"
+#include "LazyItemStore.h"
+#include "OccUtils.h"
 #include "PPP/Processor.h"
 #include "PPP/Utilities.h"
 
@@ -24,12 +26,18 @@ namespace Geom
     protected:
         Standard_Real toleranceThreshold;
         ShapeType myShapeType;
+        /// @{ item properties in columns, indexed by ItemIndexType
         std::shared_ptr<VectorType<ItemHashType>> myShapeIDs;
-        std::shared_ptr<ItemContainerType> myShapes;
-        std::shared_ptr<MapType<ItemHashType, std::string>> myNameMap;
-        std::shared_ptr<MapType<ItemHashType, Quantity_Color>> myColorMap;
-        std::shared_ptr<MapType<ItemHashType, Material>> myMaterialMap;
-        std::shared_ptr<MapType<ItemHashType, ShapeErrorType>> myShapeErrors;
+        std::shared_ptr<ItemVectorType> myShapes;
+        std::shared_ptr<VectorType<std::string>> myItemNames;
+        std::shared_ptr<VectorType<std::optional<Quantity_Color>>> myItemColors;
+        std::shared_ptr<VectorType<std::optional<Material>>> myItemMaterials;
+        std::shared_ptr<VectorType<ShapeErrorType>> myShapeErrors;
+        /// @}
+        /// secondary lookup from shape hash to item index
+        std::shared_ptr<ItemIndexMapType> myShapeIndices;
+        /// nullptr if all shapes are resident in `myShapes`, otherwise shapes are loaded on demand
+        std::shared_ptr<LazyItemStore> myShapeStore;
 
     public:
         /// consider: disable copy but enable move constructors and assigners
@@ -49,10 +57,30 @@ namespace Geom
         {
             return myInputData->itemCount();
         }
-        /// shape item is stored in a map instead of vector, for easy insertion
-        inline const TopoDS_Shape& item(const ItemIndexType index) const
+        /// shape item is stored in a dense vector, indexed access is a single memory load
+        /// return by value (a handle copy), as shape in the lazy item store may be evicted by other threads
+        inline TopoDS_Shape item(const ItemIndexType index) const
+        {
+            if (myShapeStore)
+                return myShapeStore->item(index);
+            return (*myShapes)[index];
+        }
+
+        /// hash key assigned to this item at reading, stable even if the item is evicted and reloaded
+        inline ItemHashType itemHash(const ItemIndexType index) const
+        {
+            return (*myShapeIDs)[index];
+        }
+
+        /** find item index by the hash key assigned at reading, return `itemCount()` if not found
+         * NOTE: `OccUtils::shapeHash(item(i))` must not be used as the key if shapes are loaded lazily,
+         * since a reloaded shape has a new TShape, use `itemHash(i)` instead */
+        inline ItemIndexType itemIndex(const ItemHashType hash) const
         {
-            return (*myShapes)[(*myShapeIDs)[index]];
+            auto it = myShapeIndices->find(hash);
+            if (it != myShapeIndices->end())
+                return it->second;
+            return itemCount();
         }
 
     protected: /// only derived classes can modify status
@@ -67,7 +95,10 @@ namespace Geom
             // reshape.Replace(oldShape, newShape);
             // return reshape.Apply(mothershape, TopAbs_SHAPE);
 
-            (*myShapes)[(*myShapeIDs)[index]] = newShape;
+            if (myShapeStore)
+                myShapeStore->setItem(index, newShape); // modified item is pinned in memory
+            else
+                (*myShapes)[index] = newShape;
             // currently, subtopology item of solids are not in used, so not needed to update
         }
 
@@ -80,15 +111,16 @@ namespace Geom
         /// some processor will modify shape item, so shapeIDs  and all other keys will outdate
         void updateShapeHash(const ItemIndexType index, const TopoDS_Shape& newShape)
         {
-            (*myShapeIDs)[index] = newShape.HashCode(ItemHashMax);
-            // todo: all other hash key must be updated
+            myShapeIndices->erase((*myShapeIDs)[index]);
+            (*myShapeIDs)[index] = OccUtils::shapeHash(newShape);
+            (*myShapeIndices)[(*myShapeIDs)[index]] = index;
         }
 
         /// kind of remove item from downstream processing
         inline void suppressItem(const ItemIndexType index, const ShapeErrorType etype = ShapeErrorType::UnknownError)
         {
             if (myShapeErrors)
-                (*myShapeErrors)[(*myShapeIDs)[index]] = etype;
+                (*myShapeErrors)[index] = etype; // distinct elements of vector can be written in parallel
         }
 
     public:
@@ -100,24 +132,24 @@ namespace Geom
 
         inline bool itemSuppressed(const ItemIndexType index) const
         {
-            if (myShapeErrors && myShapeErrors->find((*myShapeIDs)[index]) != myShapeErrors->end())
-                return (*myShapeErrors)[(*myShapeIDs)[index]] != ShapeErrorType::NoError;
+            if (myShapeErrors)
+                return (*myShapeErrors)[index] != ShapeErrorType::NoError;
             else
                 return false;
         }
         /// if there no name for the item, return empty string
-        inline const std::string itemName(const ItemIndexType index) const
+        inline const std::string itemName(const ItemIndexType index) const override
         {
-            if (myNameMap->find((*myShapeIDs)[index]) != myNameMap->end())
-                return (*myNameMap)[(*myShapeIDs)[index]];
+            if ((*myItemNames)[index].size())
+                return (*myItemNames)[index];
             else
                 return "item" + std::to_string(index); // do NOT return reference of local variable!
         }
 
         ShapeErrorType itemError(const ItemIndexType index) const
         {
-            if (myShapeErrors->find((*myShapeIDs)[index]) != myShapeErrors->end())
-                return (*myShapeErrors)[(*myShapeIDs)[index]];
+            if (myShapeErrors)
+                return (*myShapeErrors)[index];
             else
                 return ShapeErrorType::NoError;
         }
@@ -125,18 +157,12 @@ namespace Geom
         ///  test before use the value of the returned type `std::optional<Quantity_Color>`
         inline const std::optional<Quantity_Color> itemColor(const ItemIndexType index) const
         {
-            if (myColorMap->find((*myShapeIDs)[index]) != myColorMap->end())
-                return (*myColorMap)[(*myShapeIDs)[index]];
-            else
-                return std::nullopt;
+            return (*myItemColors)[index];
         }
         ///
         inline const std::optional<Material> itemMaterial(const ItemIndexType index) const
         {
-            if (myMaterialMap->find((*myShapeIDs)[index]) != myMaterialMap->end())
-                return (*myMaterialMap)[(*myShapeIDs)[index]];
-            else
-                return std::nullopt;
+            return (*myItemMaterials)[index];
         }
         /// @}
 
@@ -156,12 +182,15 @@ namespace Geom
 
             if (myShapeType == ShapeType::Solid and myInputData->contains("mySolids"))
             {
-                myShapes = myInputData->get<ItemContainerType>("mySolids");
-                myShapeIDs = myInputData->get<VectorType<ItemHashType>>("mySolidIDs");
-                myShapeErrors = myInputData->get<MapType<ItemHashType, ShapeErrorType>>("myShapeErrors");
-                myNameMap = myInputData->get<MapType<ItemHashType, std::string>>("myNameMap");
-                myColorMap = myInputData->get<MapType<ItemHashType, Quantity_Color>>("myColorMap");
-                myMaterialMap = myInputData->get<MapType<ItemHashType, Material>>("myMaterialMap");
+                myShapes = myInputData->get(PropertyKeys::Solids);
+                myShapeIDs = myInputData->get(PropertyKeys::SolidIDs);
+                myShapeIndices = myInputData->get(PropertyKeys::ShapeIndices);
+                myShapeErrors = myInputData->get(PropertyKeys::ShapeErrors);
+                myItemNames = myInputData->get(PropertyKeys::ItemNames);
+                myItemColors = myInputData->get(PropertyKeys::ItemColors);
+                myItemMaterials = myInputData->get(PropertyKeys::ItemMaterials);
+                if (myInputData->contains("myShapeStore"))
+                    myShapeStore = myInputData->get<LazyItemStore>("myShapeStore");
             }
             else
             {
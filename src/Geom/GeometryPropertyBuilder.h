@@ -1,6 +1,7 @@
 #pragma once
 
 #include "GeometryProcessor.h"
+#include "GeometryPropertyStore.h"
 #include "GeometryTypes.h"
 #include "OccUtils.h"
 
@@ -20,15 +21,19 @@ namespace Geom
 
     private:
         VectorType<GeometryProperty> myGeometryProperties;
+        /// the same properties in columns, for batch checks in prepareOutput()
+        GeometryPropertyStore myPropertyStore;
         VectorType<ItemIndexType> myGeometryUniqueIds;
         double myMininumVolumeThreshold;
+        double myMaximumVolumeThreshold;
         // thread_local ItemIndexType myCurrentIndex;
 
     public:
         GeometryPropertyBuilder()
         {
             // The parent's default ctor be called automatically (implicitly)
-            myCharacteristics["producedProperties"] = {"myGeometryProperties", "myGeometryUniqueIds"};
+            myCharacteristics["producedProperties"] = {"myGeometryProperties", "myGeometryPropertyStore",
+                                                       "myGeometryUniqueIds"};
             // std::cout << myCharacteristics;
         }
 
@@ -40,14 +45,18 @@ namespace Geom
         {
             GeometryProcessor::prepareInput();
             myGeometryProperties.resize(myInputData->itemCount());
+            myPropertyStore.resize(myInputData->itemCount());
             myGeometryUniqueIds.resize(myInputData->itemCount());
 
-            myMininumVolumeThreshold = 1; // todo: length unit mm, a part with volume of 1 cubic mm is an error
+            // length unit mm, a part with volume of 1 cubic mm is an error
+            myMininumVolumeThreshold = parameterValue<double>("minimumVolume", 1.0);
+            myMaximumVolumeThreshold = parameterValue<double>("maximumVolume", 1e16);
         }
 
         virtual void prepareOutput() override
         {
-            // volumeCheck();
+            volumeCheck();
+            itemPropertyCheck();
             // dump(dataStoragePath("gproperties_dump.json")); // debug dump
             // report, save and display erroneous shape
             if (myConfig.contains("output"))
@@ -59,7 +68,8 @@ namespace Geom
             {
                 LOG_F(WARNING, "user must provided output filename for meta data");
             }
-            myOutputData->emplace("myGeometryProperties", std::move(myGeometryProperties));
+            myOutputData->emplace(PropertyKeys::GeometryProperties, std::move(myGeometryProperties));
+            myOutputData->emplace(PropertyKeys::PropertyStore, std::move(myPropertyStore));
             myOutputData->emplace("myGeometryUniqueIds", std::move(myGeometryUniqueIds));
         }
 
@@ -67,38 +77,32 @@ namespace Geom
         {
             const TopoDS_Shape& aShape = item(index);
             myGeometryProperties[index] = OccUtils::geometryProperty(aShape); // no way for std::move, but obj is small
-            itemPropertyCheck(index);
+            myPropertyStore.set(index, myGeometryProperties[index]);
             myGeometryUniqueIds[index] = OccUtils::uniqueId(myGeometryProperties[index]);
         }
 
     protected:
+        /// max and min volume check, scan only the volume column of all items
         void volumeCheck()
         {
-            // max and min volume check!
-            double max_volume = 0;
-            double min_volume = 1e100;  //  unit is mm^3
-            double max_volume_threshold = 1e16; // todo: get from config parameter
-            for (size_t i = 0; i < myInputData->itemCount(); i++)
+            const auto range = myPropertyStore.volumeRange(myMininumVolumeThreshold, myMaximumVolumeThreshold);
+            if (range.first <= range.second)
+                LOG_F(INFO, "item volume range (%f, %f) mm^3 within thresholds", range.first, range.second);
+            for (const auto i : myPropertyStore.selectVolumeAbove(myMaximumVolumeThreshold))
             {
-                const auto& p = myGeometryProperties[i];
-                if (p.volume > max_volume and p.volume < max_volume_threshold)
-                    max_volume = p.volume;
-                if (p.volume < min_volume and p.volume > myMininumVolumeThreshold)
-                    min_volume = p.volume;
-                if (p.volume > max_volume_threshold)
-                    LOG_F(ERROR, "maximum volume in solids surpass the threshold %f", max_volume_threshold);
+                LOG_F(ERROR, "item %lu volume %f surpasses the maximum volume threshold %f", i,
+                      myPropertyStore.volume(i), myMaximumVolumeThreshold);
             }
         }
 
-        /// suppress and dump solid if the volume is too small
-        void itemPropertyCheck(const std::size_t i)
+        /// suppress and dump solid if the volume is too small, selected by a batch scan in serial mode
+        void itemPropertyCheck()
         {
-            const GeometryProperty& p = myGeometryProperties[i];
-            if (p.volume < myMininumVolumeThreshold)
+            for (const auto i : myPropertyStore.selectVolumeBelow(myMininumVolumeThreshold))
             {
                 if (not itemSuppressed(i)) // this can be run as a second time
                 {
-                    LOG_F(ERROR, "item volume %f < threshold %f mm^3, so suppress item %lu", p.volume,
+                    LOG_F(ERROR, "item volume %f < threshold %f mm^3, so suppress item %lu", myPropertyStore.volume(i),
                           myMininumVolumeThreshold, i);
                     suppressItem(i, ShapeErrorType::VolumeTooSmall);
                     auto df = generateDumpName("dump_smallVolume", {i}) + ".brep";
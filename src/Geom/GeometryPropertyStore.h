@@ -0,0 +1,297 @@
+// license
+#ifndef PPP_GEOMETRY_PROPERTY_STORE_H
+#define PPP_GEOMETRY_PROPERTY_STORE_H
+
+#include "GeometryTypes.h"
+
+namespace Geom
+{
+    using namespace PPP;
+
+    /// \ingroup Geom
+    /**
+     * batch kernels on contiguous arrays, used for property-based filtering of all items
+     *
+     * Loops are branchless without early exit, so compiler can auto-vectorize them (SSE/AVX by `-O2 -ftree-vectorize`
+     * or `-O3`), the output is a byte mask (`char` instead of `bool` for contiguous storage),
+     * then a cheap compaction pass collects the selected item indices.
+     */
+    namespace PropertyKernels
+    {
+        /// same as `Precision::Confusion()`, absolute tolerance for near-zero values in `floatEqual()`
+        constexpr double Confusion = 1e-7;
+
+        /// mask[i] = v[i] < threshold, return the count of selected
+        inline std::size_t maskBelow(const double* v, const std::size_t n, const double threshold, char* mask)
+        {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < n; i++)
+            {
+                const char m = v[i] < threshold;
+                mask[i] = m;
+                count += m;
+            }
+            return count;
+        }
+
+        /// mask[i] = v[i] > threshold, return the count of selected
+        inline std::size_t maskAbove(const double* v, const std::size_t n, const double threshold, char* mask)
+        {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < n; i++)
+            {
+                const char m = v[i] > threshold;
+                mask[i] = m;
+                count += m;
+            }
+            return count;
+        }
+
+        /// mask[i] = lower <= v[i] <= upper, return the count of selected
+        inline std::size_t maskInRange(const double* v, const std::size_t n, const double lower, const double upper,
+                                       char* mask)
+        {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < n; i++)
+            {
+                const char m = (v[i] >= lower) & (v[i] <= upper);
+                mask[i] = m;
+                count += m;
+            }
+            return count;
+        }
+
+        /// mask[i] = lower <= a[i]/b[i] <= upper, computed by multiplication to avoid division,
+        /// item with b[i] <= 0 is not selected
+        inline std::size_t maskRatioInRange(const double* a, const double* b, const std::size_t n, const double lower,
+                                            const double upper, char* mask)
+        {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < n; i++)
+            {
+                const char m = (b[i] > 0.0) & (a[i] >= lower * b[i]) & (a[i] <= upper * b[i]);
+                mask[i] = m;
+                count += m;
+            }
+            return count;
+        }
+
+        /// minimum and maximum of values within the open range (lower, upper), as {upper, lower} if none
+        inline std::pair<double, double> minMaxInRange(const double* v, const std::size_t n, const double lower,
+                                                       const double upper)
+        {
+            // independent lanes break the loop-carried dependency of min/max reduction
+            constexpr std::size_t L = 4;
+            double vmin[L] = {upper, upper, upper, upper};
+            double vmax[L] = {lower, lower, lower, lower};
+            const std::size_t nBlock = n - n % L;
+            for (std::size_t i = 0; i < nBlock; i += L)
+            {
+                for (std::size_t l = 0; l < L; l++)
+                {
+                    const double x = v[i + l];
+                    const bool inRange = (x > lower) & (x < upper);
+                    vmin[l] = (inRange & (x < vmin[l])) ? x : vmin[l];
+                    vmax[l] = (inRange & (x > vmax[l])) ? x : vmax[l];
+                }
+            }
+            for (std::size_t i = nBlock; i < n; i++)
+            {
+                const bool inRange = (v[i] > lower) & (v[i] < upper);
+                vmin[0] = (inRange & (v[i] < vmin[0])) ? v[i] : vmin[0];
+                vmax[0] = (inRange & (v[i] > vmax[0])) ? v[i] : vmax[0];
+            }
+            return {std::min(std::min(vmin[0], vmin[1]), std::min(vmin[2], vmin[3])),
+                    std::max(std::max(vmax[0], vmax[1]), std::max(vmax[2], vmax[3]))};
+        }
+
+        /// index of the last value equal to `ref` by `OccUtils::floatEqual()`, 0 if none is matched
+        inline std::size_t lastEqual(const double ref, const double* v, const std::size_t n, const double reltol)
+        {
+            const double absTol = Confusion * reltol;
+            std::size_t matched = 0;
+            for (std::size_t i = 0; i < n; i++)
+            {
+                const double tol = std::max(std::min(std::abs(ref), std::abs(v[i])) * reltol, absTol);
+                matched = (std::abs(ref - v[i]) < tol) ? i : matched;
+            }
+            return matched;
+        }
+
+        /// collect the indices of nonzero mask, branchless compaction given the count of nonzero
+        inline VectorType<ItemIndexType> selected(const char* mask, const std::size_t n, const std::size_t count)
+        {
+            VectorType<ItemIndexType> ids(count + 1); // the extra slot is written by unselected tail items
+            std::size_t k = 0;
+            for (std::size_t i = 0; i < n; i++)
+            {
+                ids[k] = i;
+                k += (mask[i] != 0);
+            }
+            ids.resize(count);
+            return ids;
+        }
+    } // namespace PropertyKernels
+
+    /// \ingroup Geom
+    /**
+     * \brief structure-of-arrays storage of `GeometryProperty` for all items, indexed by item index
+     *
+     * `VectorType<GeometryProperty>` (array of structs) is kept for meta data writing, while checks
+     * reading only one or two fields of all items (volume threshold, area/volume ratio) should use this store,
+     * so each scan touches only the contiguous column it needs.
+     *
+     * Thread-safety: same as `std::vector`, `set()` on different item indices can run in parallel after `resize()`.
+     */
+    class GeometryPropertyStore
+    {
+    private:
+        VectorType<double> myVolumes;
+        VectorType<double> myAreas;
+        VectorType<double> myPerimeters;
+        VectorType<double> myTolerances;
+        VectorType<int> mySolidCounts;
+        VectorType<int> myFaceCounts;
+        VectorType<int> myEdgeCounts;
+        VectorType<double> myCentersX;
+        VectorType<double> myCentersY;
+        VectorType<double> myCentersZ;
+
+    public:
+        GeometryPropertyStore() = default;
+        explicit GeometryPropertyStore(const VectorType<GeometryProperty>& properties)
+        {
+            resize(properties.size());
+            for (std::size_t i = 0; i < properties.size(); i++)
+                set(i, properties[i]);
+        }
+
+        void resize(const std::size_t n)
+        {
+            myVolumes.resize(n, 0.0);
+            myAreas.resize(n, 0.0);
+            myPerimeters.resize(n, 0.0);
+            myTolerances.resize(n, 0.0);
+            mySolidCounts.resize(n, 0);
+            myFaceCounts.resize(n, 0);
+            myEdgeCounts.resize(n, 0);
+            myCentersX.resize(n, 0.0);
+            myCentersY.resize(n, 0.0);
+            myCentersZ.resize(n, 0.0);
+        }
+
+        inline std::size_t size() const
+        {
+            return myVolumes.size();
+        }
+
+        void set(const ItemIndexType i, const GeometryProperty& p)
+        {
+            myVolumes[i] = p.volume;
+            myAreas[i] = p.area;
+            myPerimeters[i] = p.perimeter;
+            myTolerances[i] = p.tolerance;
+            mySolidCounts[i] = p.solidCount;
+            myFaceCounts[i] = p.faceCount;
+            myEdgeCounts[i] = p.edgeCount;
+            if (p.centerOfMass.size() >= 3)
+            {
+                myCentersX[i] = p.centerOfMass[0];
+                myCentersY[i] = p.centerOfMass[1];
+                myCentersZ[i] = p.centerOfMass[2];
+            }
+        }
+
+        /// gather fields back into the array-of-struct type
+        GeometryProperty property(const ItemIndexType i) const
+        {
+            GeometryProperty p;
+            p.volume = myVolumes[i];
+            p.area = myAreas[i];
+            p.perimeter = myPerimeters[i];
+            p.tolerance = myTolerances[i];
+            p.solidCount = mySolidCounts[i];
+            p.faceCount = myFaceCounts[i];
+            p.edgeCount = myEdgeCounts[i];
+            p.centerOfMass = {myCentersX[i], myCentersY[i], myCentersZ[i]};
+            return p;
+        }
+
+        /// \name column accessors
+        /// @{
+        inline double volume(const ItemIndexType i) const
+        {
+            return myVolumes[i];
+        }
+        inline double area(const ItemIndexType i) const
+        {
+            return myAreas[i];
+        }
+        inline const VectorType<double>& volumes() const
+        {
+            return myVolumes;
+        }
+        inline const VectorType<double>& areas() const
+        {
+            return myAreas;
+        }
+        inline const VectorType<double>& perimeters() const
+        {
+            return myPerimeters;
+        }
+        inline const VectorType<double>& tolerances() const
+        {
+            return myTolerances;
+        }
+        inline const VectorType<int>& faceCounts() const
+        {
+            return myFaceCounts;
+        }
+        /// @}
+
+        /// \name batch checks on all items
+        /// @{
+        /// indices of items with volume smaller than the threshold
+        VectorType<ItemIndexType> selectVolumeBelow(const double threshold) const
+        {
+            VectorType<char> mask(size());
+            auto count = PropertyKernels::maskBelow(myVolumes.data(), size(), threshold, mask.data());
+            return PropertyKernels::selected(mask.data(), size(), count);
+        }
+
+        /// indices of items with volume greater than the threshold
+        VectorType<ItemIndexType> selectVolumeAbove(const double threshold) const
+        {
+            VectorType<char> mask(size());
+            auto count = PropertyKernels::maskAbove(myVolumes.data(), size(), threshold, mask.data());
+            return PropertyKernels::selected(mask.data(), size(), count);
+        }
+
+        /// indices of items with volume in the closed range [lower, upper]
+        VectorType<ItemIndexType> selectVolumeInRange(const double lower, const double upper) const
+        {
+            VectorType<char> mask(size());
+            auto count = PropertyKernels::maskInRange(myVolumes.data(), size(), lower, upper, mask.data());
+            return PropertyKernels::selected(mask.data(), size(), count);
+        }
+
+        /// indices of items with area/volume ratio in [lower, upper], e.g. thin sheet has a large ratio
+        VectorType<ItemIndexType> selectAreaVolumeRatioInRange(const double lower, const double upper) const
+        {
+            VectorType<char> mask(size());
+            auto count =
+                PropertyKernels::maskRatioInRange(myAreas.data(), myVolumes.data(), size(), lower, upper, mask.data());
+            return PropertyKernels::selected(mask.data(), size(), count);
+        }
+
+        /// min and max volume within the open range (lower, upper), as {upper, lower} if no item is in range
+        std::pair<double, double> volumeRange(const double lower, const double upper) const
+        {
+            return PropertyKernels::minMaxInRange(myVolumes.data(), size(), lower, upper);
+        }
+        /// @}
+    };
+
+} // namespace Geom
+
+#endif
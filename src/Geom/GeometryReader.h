@@ -4,10 +4,13 @@
 
 #include "GeometryData.h"
 #include "GeometryProcessor.h"
+#include "OccUtils.h"
 #include "PPP/Reader.h"
 
 #include "OpenCascadeAll.h"
 
+#include "tbb/task_group.h"
+
 
 namespace Geom
 {
@@ -17,13 +20,13 @@ namespace Geom
     /**
      * read geometry file and generate GeometryData object
      * must be in sequential mode, should derived from App::Reader,
-     * for the input manifest of multiple geometry files list, parallel reading is possible.
+     * for the input manifest of multiple geometry files list, files are read in parallel.
      *
      * Aupported geometry file formats
      * + step/stp AP214(with material and color meta data) OpenCASCADE XCAF
      * + IGES/igs: OpenCASCADE XCAF reader
      * + FreeCAD native format  *.FCStd
-     * + parallel preproessor output: *.brep + *_metadata.json(*.metadata.json)
+     * + parallel preproessor output: *.brep or *.bbrep (OCCT binary) + *_metadata.json(*.metadata.json)
      * + manifest.json textual format: a list of filename-materail json objects
      *     this json file must ended with "manifest.json", here is an example:
      *    ```json
@@ -76,10 +79,16 @@ namespace Geom
         // MapType<ItemHashType, bool> mySuppressionMap;
         /// @}
 
+        /// translate root shapes of STEP file in parallel, configured by reader parameter `parallelTransfer`
+        bool myParallelTransfer = false;
+        /// count of distinct solids re-keyed due to hash collision, reported in `hashStatistics()`
+        std::size_t myHashCollisionCount = 0;
+
     public:
         virtual void process() override
         {
             std::string file_name = myConfig["dataFileName"];
+            myParallelTransfer = parameterValue<bool>("parallelTransfer", false);
             read(file_name);
         }
 
@@ -100,8 +109,13 @@ namespace Geom
             }
 
             // todo: HDF5 or zipped container, unzip first
-            if (Utilities::hasFileExt(file_name, "stp") || Utilities::hasFileExt(file_name, "step") ||
-                Utilities::hasFileExt(file_name, "igs") || Utilities::hasFileExt(file_name, "iges"))
+            bool isStep = Utilities::hasFileExt(file_name, "stp") || Utilities::hasFileExt(file_name, "step");
+            if (myParallelTransfer && isStep)
+            {
+                this->readXCAFDocParallel(file_name);
+            }
+            else if (Utilities::hasFileExt(file_name, "stp") || Utilities::hasFileExt(file_name, "step") ||
+                     Utilities::hasFileExt(file_name, "igs") || Utilities::hasFileExt(file_name, "iges"))
             {
                 this->readXCAFDoc(file_name);
                 this->loadXCAFDoc();
@@ -114,13 +128,14 @@ namespace Geom
             {
                 this->readManifestFile(file_name);
             }
-            else if (Utilities::hasFileExt(file_name, "brep") || Utilities::hasFileExt(file_name, "brp"))
+            else if (OccUtils::isBrepFile(file_name))
             {
                 readBrep(file_name);
             }
             else
             {
-                LOG_F(ERROR, "only file suffix .stp/.step, .iges/.igs, .brep, *manifest.json, *.FCStd are supported");
+                LOG_F(ERROR, "only file suffix .stp/.step, .iges/.igs, .brep/.bbrep, *manifest.json, *.FCStd are "
+                             "supported");
             }
             this->summary();
         }
@@ -134,6 +149,12 @@ namespace Geom
             fs::path manifest_dir = fs::path(filename).parent_path();
             std::ifstream i(filename);
             i >> manifest;
+
+            /// entries are independent files, each is loaded by a worker reader into its own containers (result slot),
+            /// then merged in the manifest order, so the result is the same as serial reading
+            std::vector<std::shared_ptr<GeometryReader>> workers; // one slot per existing entry, manifest order
+            tbb::task_group g;
+            const bool parallel = threadCount() > 1;
             for (const auto& p : manifest)
             {
                 /// NOTE: requested by ISSUE 12, filename key now accepts this pattern  "*filename"
@@ -162,13 +183,25 @@ namespace Geom
                 if (fs::exists(fs::path(file_path)))
                 {
                     LOG_F(INFO, "read file: %s", file_path.c_str());
-                    read(file_path, p);
+                    auto w = std::make_shared<GeometryReader>();
+                    w->setConfig(myConfig);
+                    workers.push_back(w);
+                    // FreeCAD file is converted into a fixed temporary folder, so it must be read in serial
+                    if (parallel and not Utilities::hasFileExt(file_path, "FCStd"))
+                        g.run([w, file_path, p]() { w->read(file_path, p); });
+                    else
+                        w->read(file_path, p);
                 }
                 else
                 {
                     LOG_F(ERROR, "input file: `%s` does not exist", file_path.c_str());
                 }
             }
+            g.wait();
+
+            for (auto& w : workers)
+                mergeShapes(*w);
+            closeDocuments(workers);
         }
 
         /**
@@ -186,13 +219,13 @@ namespace Geom
             {
                 this->readFreeCADFile(file_name);
             }
-            else if (Utilities::hasFileExt(file_name, "brep") || Utilities::hasFileExt(file_name, "brp"))
+            else if (OccUtils::isBrepFile(file_name))
             {
                 readBrep(file_name, metadata);
             }
             else
             {
-                LOG_F(ERROR, "only file suffix .stp or .step, .iges, .igs, .brep, *.FCStd are supported");
+                LOG_F(ERROR, "only file suffix .stp or .step, .iges, .igs, .brep, .bbrep, *.FCStd are supported");
             }
         }
 
@@ -227,9 +260,13 @@ namespace Geom
         {
             if (s.ShapeType() == TopAbs_SOLID)
             {
-                ItemHashType hid = s.HashCode(ItemHashMax);
-
-                mySolids.insert(std::make_pair(hid, s));
+                auto ret = insertSolid(OccUtils::shapeHash(s), s);
+                if (not ret.second)
+                {
+                    LOG_F(WARNING, "the same solid shape has been registered, skip it");
+                    return;
+                }
+                ItemHashType hid = ret.first; // may differ from shape hash if collided
 
                 // todo: step subassembly structure,  `parent`
                 if (p.contains("name") and (not p["name"].is_null()))
@@ -303,11 +340,7 @@ namespace Geom
             }
             // read a Compound or CompSolid, return a vector of TopoDS_Shape of Solid type
 
-            BRep_Builder cBuilder;
-            TopoDS_Shape shape;
-            BRepTools::Read(shape, filename.c_str(), cBuilder);
-            if (shape.IsNull())
-                throw std::runtime_error("brep read data is Null for:" + filename);
+            TopoDS_Shape shape = OccUtils::readBrep(filename); // binary format if file suffix is `.bbrep`
 
             // explore solids and calc Id
             int solidCount = 0;
@@ -419,15 +452,31 @@ namespace Geom
          * for step and iges only, using OpenCASCADE OCAF reader
          */
 
-        /** get a basic reader STEPControl_Reader */
-        void checkUnits(STEPControl_Reader& reader)
+        /** get a basic reader STEPControl_Reader, return length units of the file, used by `LengthUnitGuard` */
+        std::string checkUnits(STEPControl_Reader& reader)
         {
             TColStd_SequenceOfAsciiString theUnitLengthNames, theUnitAngleNames, theUnitSolidAngleNames;
             reader.FileUnits(theUnitLengthNames, theUnitAngleNames, theUnitSolidAngleNames);
+            std::string units = "STEP:";
             for (const auto& s : theUnitLengthNames)
             {
                 LOG_F(INFO, "length unit of input file is %s", s.ToCString());
+                units += std::string(" ") + s.ToCString();
             }
+            return units;
+        }
+
+        /// the first unit assignment context in the STEP model, or null
+        Handle(StepRepr_RepresentationContext) unitContext(const Handle(Interface_InterfaceModel)& model)
+        {
+            for (Standard_Integer i = 1; i <= model->NbEntities(); i++)
+            {
+                const auto& e = model->Value(i);
+                if (e->IsKind(STANDARD_TYPE(StepGeom_GeometricRepresentationContextAndGlobalUnitAssignedContext)) or
+                    e->IsKind(STANDARD_TYPE(StepGeom_GeomRepContextAndGlobUnitAssCtxAndGlobUncertaintyAssCtx)))
+                    return Handle(StepRepr_RepresentationContext)::DownCast(e);
+            }
+            return nullptr;
         }
 
 
@@ -438,6 +487,8 @@ namespace Geom
         {
             // app =  Handle(TDocStd_Application)::DownCast(doc->Application());
             // Handle(TDocStd_Dataset) hDoc;
+            /// XCAFApp_Application is a singleton and not thread-safe, while manifest files are read concurrently
+            std::unique_lock<std::shared_mutex> appLock(OccUtils::dataExchangeMutex());
             hApp = XCAFApp_Application::GetApplication();
             /*
             if (!CDF_Session::Exists()) {
@@ -472,9 +523,12 @@ namespace Geom
             }
             // "MDTV-CAF" is deprecated, readonly, using xml or binary format
             hApp->NewDocument(TCollection_ExtendedString("MDTV-CAF"), hDoc); //
+            appLock.unlock();
 
             try
             {
+                // translation reads global Interface_Static parameters, which a background writer may change
+                std::shared_lock<std::shared_mutex> exchangeLock(OccUtils::dataExchangeMutex());
                 bool ret = false;
                 if (Utilities::hasFileExt(file_name, "stp") || Utilities::hasFileExt(file_name, "step"))
                 {
@@ -488,7 +542,11 @@ namespace Geom
                         throw OSD_Exception("cannot read STEP file");
                     }
                     auto reader = aReader.Reader();
-                    checkUnits(reader);
+                    // transfer sets process-wide length factors, files of other units must not be transferred now,
+                    // the guard is taken before the exchange lock, as other threads may wait on them in this order
+                    exchangeLock.unlock();
+                    OccUtils::LengthUnitGuard unitGuard(checkUnits(reader));
+                    exchangeLock.lock();
                     // IFSelect_PrintCount mode = IFSelect_CountByItem;
                     // STEPControl_Reader has the check method:PrintCheckLoad(failsonly, mode);
 
@@ -518,6 +576,12 @@ namespace Geom
                     // pi->Show();
                     // Standard_Integer nbRootsForTransfer = aReader.NbRootsForTransfer();
                     aReader.NbRootsForTransfer();
+                    // IGES transfer also sets the process-wide length factors
+                    auto unitName = aReader.IGESModel()->GlobalSection().UnitName();
+                    exchangeLock.unlock();
+                    OccUtils::LengthUnitGuard unitGuard(std::string("IGES: ") +
+                                                        (unitName.IsNull() ? "" : unitName->ToCString()));
+                    exchangeLock.lock();
                     ret = aReader.Transfer(hDoc); // translate from step/iges to XDE Dataset
                     // pi->EndScope();
 
@@ -539,6 +603,243 @@ namespace Geom
             }
         }
 
+        /**
+         * parallel version of `readXCAFDoc()` + `loadXCAFDoc()` for STEP file only.
+         * STEP file is parsed once into the StepData model, which is shared (read only) by workers,
+         * each worker has its own work session and XCAF document, to transfer a subset of root entities
+         * by `STEPCAFControl_Reader::TransferOneRoot()`, then loads shapes and meta data into
+         * a worker's own containers. Worker containers are merged in worker order, so result is deterministic.
+         * Parallelism is limited by the number of root entities, a STEP file with a single root
+         * (one top-level assembly) is transferred by one worker, i.e. no speedup.
+         *
+         * NOTE: documents are created and closed in the main thread with `OccUtils::dataExchangeMutex()` locked,
+         * since XCAFApp_Application is not thread-safe. Each worker's session is bound to the shared model,
+         * and its graph and root list are computed, serially before tasks start, as `SetModel()` modifies the model.
+         */
+        bool readXCAFDocParallel(std::string file_name, const json metadata = json())
+        {
+            hApp = XCAFApp_Application::GetApplication();
+            Handle(Interface_InterfaceModel) model;
+            Standard_Integer nbRoots = 0;
+            std::string units;
+            try
+            {
+                std::shared_lock<std::shared_mutex> exchangeLock(OccUtils::dataExchangeMutex());
+                STEPCAFControl_Reader aReader;
+                if (aReader.ReadFile((Standard_CString)(file_name.c_str())) != IFSelect_RetDone)
+                {
+                    throw OSD_Exception("cannot read STEP file");
+                }
+                auto reader = aReader.Reader();
+                units = checkUnits(reader);
+                nbRoots = aReader.NbRootsForTransfer();
+                model = reader.WS()->Model();
+            }
+            catch (OSD_Exception& e)
+            {
+                LOG_F(ERROR, "Error during reading step file in OCCT: %s\n", e.GetMessageString());
+                return false;
+            }
+
+            const size_t nWorkers = std::max<size_t>(1, std::min<size_t>(threadCount(), nbRoots));
+            if (nbRoots <= 1)
+                LOG_F(INFO, "STEP file has a single root entity, it can not be transferred in parallel");
+            LOG_F(INFO, "transfer %d root entities of STEP file by %lu threads", nbRoots, nWorkers);
+            std::vector<std::shared_ptr<GeometryReader>> workers;
+            std::vector<std::shared_ptr<STEPCAFControl_Reader>> readers;
+            // held until all roots are transferred, so no file of another unit is transferred meanwhile
+            OccUtils::LengthUnitGuard unitGuard(units);
+            try
+            {
+                std::unique_lock<std::shared_mutex> appLock(OccUtils::dataExchangeMutex());
+                for (size_t t = 0; t < nWorkers; t++)
+                {
+                    auto w = std::make_shared<GeometryReader>();
+                    w->hApp = hApp;
+                    hApp->NewDocument(TCollection_ExtendedString("MDTV-CAF"), w->hDoc);
+                    workers.push_back(w);
+
+                    auto tReader = std::make_shared<STEPCAFControl_Reader>(); // has its own work session
+                    tReader->SetColorMode(true);
+                    tReader->SetNameMode(true);
+                    tReader->SetMatMode(true);
+                    tReader->Reader().WS()->SetModel(model);
+                    tReader->Reader().WS()->ComputeGraph(Standard_True);
+                    tReader->Reader().NbRootsForTransfer(); // root list is computed lazily, do it here
+                    readers.push_back(tReader);
+                }
+#if OCC_VERSION_HEX < 0x070800
+                // the actor sets process-wide length factors (`UnitsMethods`) from the file units, do it once here,
+                // then each `TransferOneRoot()` in parallel writes the same values, not racing with another unit
+                auto transferReader = readers.front()->Reader().WS()->TransferReader();
+                auto actor = Handle(STEPControl_ActorRead)::DownCast(transferReader->Actor());
+                auto context = unitContext(model);
+                if (not actor.IsNull() and not context.IsNull())
+                {
+                    Handle(Transfer_TransientProcess) TP = new Transfer_TransientProcess(model->NbEntities());
+                    TP->SetModel(model);
+                    actor->PrepareUnits(context, TP);
+                }
+#endif
+            }
+            catch (Standard_Failure& e)
+            {
+                LOG_F(ERROR, "Error during preparing parallel transfer of STEP file: %s\n", e.GetMessageString());
+                closeDocuments(workers);
+                return false;
+            }
+
+            std::vector<int> rets(nWorkers, 1);
+            tbb::task_group g;
+            for (size_t t = 0; t < nWorkers; t++)
+            {
+                g.run([&, t]() {
+                    auto& w = workers[t];
+                    auto& tReader = *readers[t];
+                    try
+                    {
+                        std::shared_lock<std::shared_mutex> exchangeLock(OccUtils::dataExchangeMutex());
+                        // roots are distributed in round-robin, as big assemblies are usually clustered
+                        for (Standard_Integer r = 1 + static_cast<Standard_Integer>(t); r <= nbRoots;
+                             r += static_cast<Standard_Integer>(nWorkers))
+                        {
+                            if (!tReader.TransferOneRoot(r, w->hDoc))
+                            {
+                                LOG_F(ERROR, "failed to transfer STEP root entity #%d", r);
+                                rets[t] = 0;
+                            }
+                        }
+                        exchangeLock.unlock();
+                        w->loadXCAFDoc(metadata);
+                    }
+                    catch (Standard_Failure& e)
+                    {
+                        LOG_F(ERROR, "Error during parallel transfer of STEP file in OCCT: %s\n",
+                              e.GetMessageString());
+                        rets[t] = 0;
+                    }
+                });
+            }
+            g.wait();
+            readers.clear(); // work sessions must not outlive the documents
+
+            for (auto& w : workers)
+                mergeShapes(*w);
+            closeDocuments(workers);
+            return std::all_of(rets.cbegin(), rets.cend(), [](int r) { return r != 0; });
+        }
+
+        /// close documents of worker readers, in main thread
+        void closeDocuments(std::vector<std::shared_ptr<GeometryReader>>& workers)
+        {
+            std::unique_lock<std::shared_mutex> appLock(OccUtils::dataExchangeMutex());
+            for (auto& w : workers)
+            {
+                if (not w->hDoc.IsNull())
+                    XCAFApp_Application::GetApplication()->Close(w->hDoc);
+            }
+        }
+
+        /// merge shapes and meta data loaded by another reader instance, called in main thread
+        void mergeShapes(GeometryReader& other)
+        {
+            for (auto& it : other.mySolids)
+            {
+                auto ret = insertSolid(it.first, it.second);
+                if (not ret.second)
+                    LOG_F(ERROR, "the same solid shape has been loaded by another reader");
+                else if (ret.first != it.first) // re-keyed due to hash collision, meta data must follow
+                {
+                    rekey(other.myNameMap, it.first, ret.first);
+                    rekey(other.myColorMap, it.first, ret.first);
+                    rekey(other.myMaterialMap, it.first, ret.first);
+                }
+            }
+            myShells.insert(other.myShells.cbegin(), other.myShells.cend());
+            myCompounds.insert(other.myCompounds.cbegin(), other.myCompounds.cend());
+            myOtherShapes.insert(other.myOtherShapes.cbegin(), other.myOtherShapes.cend());
+            myNameMap.insert(other.myNameMap.cbegin(), other.myNameMap.cend());
+            myColorMap.insert(other.myColorMap.cbegin(), other.myColorMap.cend());
+            myMaterialMap.insert(other.myMaterialMap.cbegin(), other.myMaterialMap.cend());
+            other.mySolids.clear();
+            other.myShells.clear();
+            other.myCompounds.clear();
+            other.myOtherShapes.clear();
+        }
+
+        /**
+         * insert solid with explicit hash collision detection, by `TopoDS_Shape::IsSame()`
+         * if a distinct solid has the same key, the key is rehashed until a free slot is found,
+         * @return the key used and false if the same solid has been inserted, like `std::unordered_map::insert()`
+         */
+        std::pair<ItemHashType, bool> insertSolid(ItemHashType hid, const TopoDS_Shape& s)
+        {
+            auto it = mySolids.find(hid);
+            while (it != mySolids.end())
+            {
+                if (it->second.IsSame(s))
+                    return {hid, false};
+                myHashCollisionCount++;
+                LOG_F(WARNING, "hash collision of distinct solids for key %lu, rehashed", hid);
+                hid = nextProbe(hid);
+                it = mySolids.find(hid);
+            }
+            mySolids.emplace(hid, s);
+            return {hid, true};
+        }
+
+        /// LCG step as probing sequence of `insertSolid()`
+        static ItemHashType nextProbe(ItemHashType hid)
+        {
+            return hid * 6364136223846793005ULL + 1442695040888963407ULL;
+        }
+
+        /**
+         * key of meta data for a shape: the key under which the same solid has been inserted by `insertSolid()`,
+         * which may differ from shape hash if collided, otherwise (not a solid) the shape hash
+         */
+        ItemHashType metadataKey(const TopoDS_Shape& s) const
+        {
+            const ItemHashType h = OccUtils::shapeHash(s);
+            ItemHashType hid = h;
+            auto it = mySolids.find(hid);
+            while (it != mySolids.end())
+            {
+                if (it->second.IsSame(s))
+                    return hid;
+                hid = nextProbe(hid);
+                it = mySolids.find(hid);
+            }
+            return h;
+        }
+
+        template <typename T> static void rekey(MapType<ItemHashType, T>& m, ItemHashType from, ItemHashType to)
+        {
+            auto it = m.find(from);
+            if (it != m.end())
+            {
+                T v = it->second;
+                m.erase(it);
+                m[to] = v;
+            }
+        }
+
+    public:
+        /// hash quality of solid container: collision count, load factor and the max bucket size
+        json hashStatistics() const
+        {
+            std::size_t maxBucketSize = 0;
+            for (std::size_t b = 0; b < mySolids.bucket_count(); b++)
+                maxBucketSize = std::max(maxBucketSize, mySolids.bucket_size(b));
+            json j;
+            j["itemCount"] = mySolids.size();
+            j["hashCollisionCount"] = myHashCollisionCount;
+            j["loadFactor"] = mySolids.load_factor();
+            j["maxBucketSize"] = maxBucketSize;
+            return j;
+        }
+
+    protected:
         /** all prepration before traversing and processing
          * todo: overloading by providing default material property via json meta data
          */
@@ -562,7 +863,9 @@ namespace Geom
             }
         }
 
-        void extractXCAFMetadata(const TDF_Label& label, const TopoDS_Shape& aShape, const json metadata = json())
+        /// meta data of `label` is saved with `key`, which is returned by `insertSolid()` for a solid shape
+        void extractXCAFMetadata(const TDF_Label& label, const TopoDS_Shape& aShape, const ItemHashType key,
+                                 const json metadata = json())
         {
             // getting material
             Handle(XCAFDoc_Material) MatAttr;
@@ -571,14 +874,14 @@ namespace Geom
                 Material m;
                 m.name = MatAttr->GetName()->ToCString();
                 m.density = MatAttr->GetDensity();
-                myMaterialMap[aShape.HashCode(ItemHashMax)] = m;
+                myMaterialMap[key] = m;
             }
             else
             {
                 if (not metadata.is_null())
                 {
                     Material m = metadata["material"];
-                    myMaterialMap[aShape.HashCode(ItemHashMax)] = m;
+                    myMaterialMap[key] = m;
                 }
             }
 
@@ -589,7 +892,7 @@ namespace Geom
                 myColorTool->GetColor(label, XCAFDoc_ColorCurv, col))
             {
                 // add defined color
-                myColorMap[aShape.HashCode(ItemHashMax)] = col;
+                myColorMap[key] = col;
             }
             /*  getting color of solids instead of all other subshapes
             else
@@ -603,7 +906,7 @@ namespace Geom
                         myColorTool->GetColor(it.Value(), XCAFDoc_ColorCurv, col))
                     {
                         // add defined color
-                        myColorMap[it.Value().HashCode(ItemHashMax)] = col;
+                        myColorMap[OccUtils::shapeHash(it.Value())] = col;
                     }
                 }
             }
@@ -618,7 +921,7 @@ namespace Geom
                 extstr.ToUTF8CString(str);
                 std::string label(str);
                 if (!label.empty()) //  'Open CASCADE STEP translator 7.3 5' not quite useful
-                    myNameMap[aShape.HashCode(ItemHashMax)] = label;
+                    myNameMap[key] = label;
                 delete[] str;
             }
 
@@ -635,7 +938,7 @@ namespace Geom
                     {
                         /* left is empty */
                     }
-                    myNameMap[aShape.HashCode(ItemHashMax)] = pname;
+                    myNameMap[key] = pname;
                 }
             }
         }
@@ -645,6 +948,8 @@ namespace Geom
             TopoDS_Shape aShape;
             if (myShapeTool->GetShape(label, aShape))
             {
+                ItemHashType key = 0; // key of meta data, set if this label's shape is inserted as a solid here
+                bool keyFound = false;
                 // if (myShapeTool->IsReference(label)) {
                 //    TDF_Label reflabel;
                 //    if (myShapeTool->GetReferredShape(label, reflabel)) {
@@ -660,37 +965,37 @@ namespace Geom
                     for (xp.Init(aShape, TopAbs_SOLID); xp.More(); xp.Next(), ctSolids++)
                     {
                         //
-                        auto hKey = xp.Current().HashCode(ItemHashMax);
-                        if (mySolids.find(hKey) == mySolids.end())
+                        auto ret = insertSolid(OccUtils::shapeHash(xp.Current()), xp.Current());
+                        // todo: assembly parent relationship
+                        if (not ret.second)
+                            LOG_F(ERROR, "the same solid shape has been loaded");
+                        else if (xp.Current().IsSame(aShape))
                         {
-                            this->mySolids[hKey] = (xp.Current());
-                            // todo: register metadata
-                            // todo: assembly parent relationship
+                            key = ret.first; // may differ from shape hash if collided
+                            keyFound = true;
                         }
-                        else
-                            LOG_F(ERROR, "shape hash key has existed");
                     }
                     for (xp.Init(aShape, TopAbs_SHELL); xp.More(); xp.Next(), ctShells++)
-                        this->myShells[xp.Current().HashCode(ItemHashMax)] = (xp.Current());
+                        this->myShells[OccUtils::shapeHash(xp.Current())] = (xp.Current());
                     // if no solids and no shells were found then go for compounds
                     if (ctSolids == 0 && ctShells == 0)
                     {
                         for (xp.Init(aShape, TopAbs_COMPOUND); xp.More(); xp.Next(), ctComps++)
                         {
-                            this->myCompounds[xp.Current().HashCode(ItemHashMax)] = (xp.Current());
+                            this->myCompounds[OccUtils::shapeHash(xp.Current())] = (xp.Current());
                             // solids should have been extracted
                         }
                     }
                     if (ctComps == 0)
                     { // why not   `&& ctSolids == 0 && ctShells == 0`
                         for (xp.Init(aShape, TopAbs_FACE, TopAbs_SHELL); xp.More(); xp.Next())
-                            this->myOtherShapes[xp.Current().HashCode(ItemHashMax)] = (xp.Current());
+                            this->myOtherShapes[OccUtils::shapeHash(xp.Current())] = (xp.Current());
                         for (xp.Init(aShape, TopAbs_WIRE, TopAbs_FACE); xp.More(); xp.Next())
-                            this->myOtherShapes[xp.Current().HashCode(ItemHashMax)] = (xp.Current());
+                            this->myOtherShapes[OccUtils::shapeHash(xp.Current())] = (xp.Current());
                         for (xp.Init(aShape, TopAbs_EDGE, TopAbs_WIRE); xp.More(); xp.Next())
-                            this->myOtherShapes[xp.Current().HashCode(ItemHashMax)] = (xp.Current());
+                            this->myOtherShapes[OccUtils::shapeHash(xp.Current())] = (xp.Current());
                         for (xp.Init(aShape, TopAbs_VERTEX, TopAbs_EDGE); xp.More(); xp.Next())
-                            this->myOtherShapes[xp.Current().HashCode(ItemHashMax)] = (xp.Current());
+                            this->myOtherShapes[OccUtils::shapeHash(xp.Current())] = (xp.Current());
                     }
 
                     gp_Pnt pos; // not in used, also like volume, can be used to validate geometry
@@ -700,7 +1005,10 @@ namespace Geom
                         pos = C->Get();
                 }
 
-                extractXCAFMetadata(label, aShape, metadata);
+                // shape of a component label is inserted by its top level label, find the key it was inserted with
+                if (not keyFound)
+                    key = metadataKey(aShape);
+                extractXCAFMetadata(label, aShape, key, metadata);
 
                 // assembly supported, while the processed lose structure info
                 // sub-assembly can be natural boundary for geometry decomposition
@@ -746,24 +1054,61 @@ namespace Geom
 
         /** only items of ShapeType::Solid will be move
          * after move, private members such as mySolids are empty,
-         * using the public property get and set API
+         * using the public property get and set API.
+         * Shapes and meta data collected in hash maps are converted into dense columns indexed by ItemIndexType,
+         * the hash is kept only as the secondary lookup `myShapeIndices`
          */
         void moveShapeIntoPropertyContainer()
         {
+            const std::size_t N = mySolids.size();
+            json hashInfo = hashStatistics();
+            LOG_F(INFO, "shape hash statistics: %s", hashInfo.dump().c_str());
+            ItemVectorType shapes;
             std::vector<ItemHashType> mySolidIDs;
-            MapType<ItemHashType, ShapeErrorType> myShapeErrors;
+            ItemIndexMapType myShapeIndices;
+            VectorType<ShapeErrorType> myShapeErrors(N, ShapeErrorType::NoError);
+            VectorType<std::string> myItemNames(N);
+            VectorType<std::optional<Quantity_Color>> myItemColors(N);
+            VectorType<std::optional<Material>> myItemMaterials(N);
+            shapes.reserve(N);
+            mySolidIDs.reserve(N);
+            myShapeIndices.reserve(N);
             for (auto const& item : mySolids) // what is the sequence?
             {
-                mySolidIDs.push_back(item.first); // the sequence
-                myShapeErrors[item.first] = ShapeErrorType::NoError;
+                const ItemIndexType i = shapes.size();
+                const ItemHashType h = item.first;
+                shapes.push_back(item.second);
+                mySolidIDs.push_back(h); // the sequence
+                myShapeIndices[h] = i;
+                if (myNameMap.find(h) != myNameMap.end())
+                    myItemNames[i] = myNameMap[h];
+                if (myColorMap.find(h) != myColorMap.end())
+                    myItemColors[i] = myColorMap[h];
+                if (myMaterialMap.find(h) != myMaterialMap.end())
+                    myItemMaterials[i] = myMaterialMap[h];
+            }
+            mySolids.clear();
+
+            /// lazy loading: shapes are saved into an archive and released from the dense vector
+            double memoryBudget = parameterValue<double>("itemMemoryBudget", 0.0); // in MB, zero to disable
+            if (memoryBudget > 0)
+            {
+                auto archive = dataStorage().getFullPath("mySolids.archive");
+                auto store = std::make_shared<LazyItemStore>(archive, std::size_t(memoryBudget * 1024 * 1024));
+                store->build(shapes);
+                for (auto& s : shapes)
+                    s.Nullify();
+                myOutputData->set<LazyItemStore>("myShapeStore", store);
             }
 
             myOutputData->setValue<ShapeType>("myShapeType", ShapeType::Solid);
-            myOutputData->setItemCount(mySolids.size());
+            myOutputData->setItemCount(N);
             // emplace equal to the two step above
-            myOutputData->emplace("mySolids", std::move(mySolids));
+            myOutputData->emplace("mySolids", std::move(shapes));
             myOutputData->emplace("mySolidIDs", std::move(mySolidIDs));
+            myOutputData->emplace("myShapeIndices", std::move(myShapeIndices));
             myOutputData->emplace("myShapeErrors", std::move(myShapeErrors));
+            myOutputData->emplace("myHashStatistics", std::move(hashInfo));
 
             // those three types are not used in this PPP
             myOutputData->emplace("myShells", std::move(myShells));
@@ -771,9 +1116,9 @@ namespace Geom
             myOutputData->emplace("myOtherShapes", std::move(myOtherShapes));
 
             // STEP214 meta data
-            myOutputData->emplace("myColorMap", std::move(myColorMap));
-            myOutputData->emplace("myMaterialMap", std::move(myMaterialMap));
-            myOutputData->emplace<MapType<ItemHashType, std::string>>("myNameMap", std::move(myNameMap));
+            myOutputData->emplace("myItemNames", std::move(myItemNames));
+            myOutputData->emplace("myItemColors", std::move(myItemColors));
+            myOutputData->emplace("myItemMaterials", std::move(myItemMaterials));
         }
 
     }; // end of class
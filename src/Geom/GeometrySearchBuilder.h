@@ -1,6 +1,7 @@
 #pragma once
 
 
+#include "BoundBoxTree.h"
 #include "GeometryProcessor.h"
 #include "OccUtils.h"
 
@@ -11,8 +12,7 @@ namespace Geom
     /**
      * to specify search input criteria and also decide the search input values
      *
-     * CONSIDER: boundbox tree may be build to accelerate research by boundbox
-     *       need a relative tolerance like to judge identical or similarity
+     * BoundBox search is accelerated by a boundbox tree (BVH), the relation is given by `BoundBoxQueryType`
      * */
     enum class ShapeSearchType
     {
@@ -52,12 +52,16 @@ namespace Geom
 
         std::vector<UniqueIdType> myUniqueIds;
         std::vector<Bnd_Box> myBoundBoxes;
+        BoundBoxQueryType myBoundBoxQueryType = BoundBoxQueryType::Coincident;
+        /// relative tolerance for Coincident, absolute tolerance for Intersect and Contain
+        double myBoundBoxTolerance = 1e-2;
         /// filename holding geometry to search, or just a list of TopoDS_Shape
         std::vector<std::string> myGeometryFiles;
 
         bool suppressMatched = false;
 
         std::shared_ptr<VectorType<Bnd_Box>> myShapeBoundBoxes;
+        std::shared_ptr<BoundBoxArray> myPackedBoundBoxes;
         std::shared_ptr<VectorType<GeometryProperty>> myGeometryProperties;
         std::shared_ptr<VectorType<Bnd_OBB>> myShapeOrientedBoundBoxes;
 
@@ -82,12 +86,15 @@ namespace Geom
 
             GeometryProcessor::prepareInput();
 
-            myShapeBoundBoxes = myInputData->get<VectorType<Bnd_Box>>("myShapeBoundBoxes");
-            GeometryProcessor::prepareInput();
-            if (myInputData->contains("myShapeOrientedBoundBoxes"))
-                myShapeOrientedBoundBoxes = myInputData->get<VectorType<Bnd_OBB>>("myShapeOrientedBoundBoxes");
+            myShapeBoundBoxes = myInputData->get(PropertyKeys::ShapeBoundBoxes);
+            if (myInputData->contains(PropertyKeys::PackedBoundBoxes))
+                myPackedBoundBoxes = myInputData->get(PropertyKeys::PackedBoundBoxes);
+            else
+                myPackedBoundBoxes = std::make_shared<BoundBoxArray>(*myShapeBoundBoxes);
+            if (myInputData->contains(PropertyKeys::ShapeOrientedBoundBoxes))
+                myShapeOrientedBoundBoxes = myInputData->get(PropertyKeys::ShapeOrientedBoundBoxes);
 
-            myGeometryProperties = myInputData->get<VectorType<GeometryProperty>>("myGeometryProperties");
+            myGeometryProperties = myInputData->get(PropertyKeys::GeometryProperties);
 
             parseSearchInput();
             /// prepare private properties like `std::vector<T>.resize(myInputData->itemCount());`
@@ -97,6 +104,8 @@ namespace Geom
                 auto m = VectorType<bool>(myInputData->itemCount(), false);
                 myMatchedResults.emplace_back(m);
             }
+            if (myShapeSearchType == ShapeSearchType::BoundBox)
+                matchBoundBoxes();
         }
 
         /**
@@ -158,6 +167,8 @@ namespace Geom
                     myBoundBoxes.emplace_back(b);
                 }
                 myFilterCount = myBoundBoxes.size();
+                myBoundBoxQueryType = parameterValue<BoundBoxQueryType>("boundBoxQuery", myBoundBoxQueryType);
+                myBoundBoxTolerance = parameterValue<double>("boundBoxTolerance", myBoundBoxTolerance);
             }
             else if (myShapeSearchType == ShapeSearchType::GeometryFile)
             {
@@ -176,6 +187,9 @@ namespace Geom
 
         void matchItem(const ItemIndexType index)
         {
+            // all items have been matched in a batch by matchBoundBoxes(), do not force a lazy shape load
+            if (myShapeSearchType == ShapeSearchType::BoundBox)
+                return;
             const auto& s = item(index);
             for (size_t r = 0; r < myFilterCount; r++)
             {
@@ -186,11 +200,6 @@ namespace Geom
                     const UniqueIdType uid = myUniqueIds[r];
                     matched[index] = matchUniqueId(s, uid);
                 }
-                else if (myShapeSearchType == ShapeSearchType::BoundBox)
-                {
-                    const Bnd_Box& box = myBoundBoxes[r];
-                    matched[index] = matchBoundBox(index, box);
-                }
                 else if (myShapeSearchType == ShapeSearchType::GeometryFile)
                 {
                     // todo
@@ -208,10 +217,24 @@ namespace Geom
             return id == uid; // todo: math with tolerance, or make UniqueID a class
         }
 
-        bool matchBoundBox(const ItemIndexType index, const Bnd_Box& bbox) const
+        /// build the boundbox tree once, then answer all searched boxes by tree traversal, in serial mode
+        void matchBoundBoxes()
         {
-            const Bnd_Box& box = (*myShapeBoundBoxes)[index];
-            return OccUtils::isBndBoxCoincident(bbox, box);
+            BoundBoxTree tree(*myPackedBoundBoxes);
+            size_t matchedCount = 0;
+            for (size_t r = 0; r < myFilterCount; r++)
+            {
+                double box[BoundBoxArray::Dim * 2];
+                BoundBoxArray::unpack(myBoundBoxes[r], box);
+                auto& matched = myMatchedResults[r];
+                for (const auto i : tree.query(box, myBoundBoxQueryType, myBoundBoxTolerance))
+                {
+                    matched[i] = true;
+                    matchedCount++;
+                }
+            }
+            VLOG_F(LOGLEVEL_DEBUG, "%lu items are matched by %lu boxes, boundbox tree has %lu nodes", matchedCount,
+                   myFilterCount, tree.nodeCount());
         }
 
         void writeResult(const std::string filename)
@@ -2,6 +2,7 @@
 #pragma once
 #include "OpenCascadeAll.h"
 #include "PPP/TypeDefs.h"
+#include <optional>
 
 
 /// automatically conversion from OpenCASCADE Bnd_Box to json array type
@@ -44,14 +45,18 @@ namespace Geom
 
     /// each module should have a typedef ItemType
     typedef TopoDS_Shape ItemType;
-    /// std::numeric_limits<Standard_Integer>::max(), is that 32bit int enough?
-    typedef Standard_Integer ItemHashType;
-    static const ItemHashType ItemHashMax = INT_MAX;
+    /** 64bit shape hash generated by `OccUtils::shapeHash()`,
+     * 32bit `TopoDS_Shape::HashCode(INT_MAX)` has birthday collisions for assemblies of 100k parts */
+    typedef std::uint64_t ItemHashType;
 
     typedef std::uint64_t UniqueIdType; // also define in PPP/UniqueId.h
-    /// map has order (non contiguous in memory), can increase capacity
+    /// map has order (non contiguous in memory), can increase capacity, used by reader to collect shapes
     typedef MapType<ItemHashType, TopoDS_Shape> ItemContainerType;
     typedef std::shared_ptr<ItemContainerType> ItemContainerPType;
+    /// dense item storage indexed by ItemIndexType, so indexed access is a single memory load
+    typedef VectorType<TopoDS_Shape> ItemVectorType;
+    /// secondary lookup from shape hash to item index
+    typedef MapType<ItemHashType, ItemIndexType> ItemIndexMapType;
 
     /**
      * from OCCT to FreeCAD style better enum name
@@ -135,6 +140,7 @@ namespace Geom
                                                     {FaceContact, "FaceContact"},
                                                     {EdgeContact, "EdgeContact"},
                                                     {VertexContact, "VertexContact"},
+                                                    {WeakInterference, "WeakInterference"},
                                                     {Interference, "Interference"},
                                                     {Coincidence, "Coincidence"},
                                                     {Enclosure, "Enclosure"},
@@ -174,6 +180,13 @@ namespace Geom
     {
         j = json{{"firstIndex", p.first}, {"secondIndex", p.second}, {"value", p.value}, {"collisionType", p.type}};
     }
+    inline void from_json(const json& j, CollisionInfo& p)
+    {
+        j.at("firstIndex").get_to(p.first);
+        j.at("secondIndex").get_to(p.second);
+        j.at("value").get_to(p.value);
+        j.at("collisionType").get_to(p.type);
+    }
 
 
     /**
@@ -32,21 +32,27 @@ namespace Geom
         /// @}
 
         bool mergeResultShapes = true;
-        std::shared_ptr<const ItemContainerType> mySolids;
-        std::shared_ptr<const MapType<ItemHashType, ShapeErrorType>> myShapeErrors;
+        std::shared_ptr<const ItemVectorType> mySolids;
+        /// nullptr if all shapes are resident in `mySolids`
+        std::shared_ptr<LazyItemStore> myShapeStore;
+        std::shared_ptr<const VectorType<ShapeErrorType>> myShapeErrors;
 
     public:
         virtual void prepareInput() override final
         {
             /// NOTE: currently only deal with solid shapes
             if (myInputData->contains("mySolids"))
-                mySolids = myInputData->getConst<ItemContainerType>("mySolids");
+                mySolids = myInputData->getConst<ItemVectorType>("mySolids");
             else
                 LOG_F(ERROR, "there is no mySolids property in myGeometryData");
 
+            // shapes are loaded on demand, they are streamed into the output shape one by one in writing
+            if (myInputData->contains("myShapeStore"))
+                myShapeStore = myInputData->get<LazyItemStore>("myShapeStore");
+
             // GeometryWriter is not derived from GeometryProcessor, so "myShapeErrors" is not available
             if (myInputData->contains("myShapeErrors"))
-                myShapeErrors = myInputData->getConst<MapType<ItemHashType, ShapeErrorType>>("myShapeErrors");
+                myShapeErrors = myInputData->getConst<VectorType<ShapeErrorType>>("myShapeErrors");
             else
                 LOG_F(ERROR, "myShapeErrors data entry is not available in the inputData");
         }
@@ -58,6 +64,9 @@ namespace Geom
             std::string file_name = parameterValue<std::string>("dataFileName");
             if (not fs::path(file_name).is_absolute())
                 file_name = dataStoragePath(file_name);
+            /// binary brep is much faster to write and read back for large assemblies, but not human readable
+            if (parameterValue<bool>("binaryBrep", false) and OccUtils::isBrepFile(file_name))
+                file_name = fs::path(file_name).replace_extension(".bbrep").string();
             if (file_name.size())
             {
                 exportGeometry(file_name);
@@ -72,16 +81,20 @@ namespace Geom
         {
             summary();
             // actual merge happends here, instead of GeometryImprinter
+            TopoDS_CompSolid compSolid;
+            TopoDS_Builder cBuilder;
+            cBuilder.MakeCompSolid(compSolid);
+            forEachResultSolid(true, [&](const ItemIndexType, const TopoDS_Shape& s) { cBuilder.Add(compSolid, s); });
             TopoDS_Shape finalShape;
             if (mergeResultShapes)
-                finalShape = OccUtils::glueFaces(OccUtils::createCompSolid(*mySolids, myShapeErrors));
+                finalShape = OccUtils::glueFaces(compSolid);
             else
             {
                 LOG_F(INFO, "result is not merged (duplicated face removed) for result brep file");
-                finalShape = OccUtils::createCompSolid(*mySolids, myShapeErrors);
+                finalShape = compSolid;
             }
 
-            BRepTools::Write(finalShape, file_name.c_str()); //  progress reporter can be the last arg
+            OccUtils::writeBrep(finalShape, file_name); // binary format if file suffix is `.bbrep`
             /// NOTE: exportMetaData() is done in the second GeometryPropertyBuilder processor
             LOG_F(INFO, "save the processed geometry compoSolid into file: %s", file_name.c_str());
         }
@@ -91,8 +104,8 @@ namespace Geom
         void summary()
         {
             auto count = 0UL;
-            for (const auto& p : (*myShapeErrors))
-                if (p.second == ShapeErrorType::NoError)
+            for (const auto& e : (*myShapeErrors))
+                if (e == ShapeErrorType::NoError)
                     count++;
 
             if (count == 0UL)
@@ -100,11 +113,29 @@ namespace Geom
 
             std::stringstream sout;
             sout << " ======= write geometry summary =======" << std::endl;
-            sout << "count of result solids is " << count << " out of total " << mySolids->size() << std::endl;
+            sout << "count of result solids is " << count << " out of total " << myShapeErrors->size() << std::endl;
 
             LOG_F(INFO, "%s", sout.str().c_str());
         }
 
+        /** visit result solids in item index order, a lazily loaded shape is streamed from the shape archive
+         * without filling the item cache or a dense copy, suppressed items are not loaded if skipped.
+         * The output shape still references all visited solids, as a single output file needs all of them. */
+        void forEachResultSolid(const bool skipSuppressed,
+                                std::function<void(const ItemIndexType, const TopoDS_Shape&)> visit) const
+        {
+            const ItemIndexType N = myShapeErrors->size();
+            for (ItemIndexType i = 0; i < N; i++)
+            {
+                if (skipSuppressed and (*myShapeErrors)[i] != ShapeErrorType::NoError)
+                    continue;
+                if (myShapeStore)
+                    visit(i, myShapeStore->itemUncached(i));
+                else
+                    visit(i, (*mySolids)[i]);
+            }
+        }
+
         // TODO: query inputData() metadata for inputUnit
         /// return 1 which means no scaling is needed
         /// not quite useful for
@@ -129,23 +160,27 @@ namespace Geom
             summary();
 
             // actual merge happends here, instead of GeometryImprinter
+            TopoDS_Compound compound;
+            TopoDS_Builder cBuilder;
+            cBuilder.MakeCompound(compound);
+            forEachResultSolid(true, [&](const ItemIndexType, const TopoDS_Shape& s) { cBuilder.Add(compound, s); });
             TopoDS_Shape finalShape;
             if (mergeResultShapes)
             {
-                finalShape = OccUtils::glueFaces(OccUtils::createCompound(*mySolids, myShapeErrors));
+                finalShape = OccUtils::glueFaces(compound);
                 VLOG_F(LOGLEVEL_DEBUG, "result shap is merged (duplicated face removed)");
             }
             else
             {
                 LOG_F(INFO, "result is not merged (duplicated face removed) for result brep file");
-                finalShape = OccUtils::createCompound(*mySolids, myShapeErrors);
+                finalShape = compound;
             }
 
             if (scale != 1) // double type has integer value can be compared with integer by ==
                 finalShape = OccUtils::scaleShape(finalShape, scale);
 
             /// NOTE: exportMetaData()  is done in the second GeometryPropertyBuilder processor
-            BRepTools::Write(finalShape, file_name.c_str()); //  progress reporter can be the last arg
+            OccUtils::writeBrep(finalShape, file_name); // binary format if file suffix is `.bbrep`
         }
 
         /** export result shape, only brep format can keep shared face topology during imprinting
@@ -157,13 +192,19 @@ namespace Geom
             auto outputUnit = parameterValue<std::string>("outputUnit", defaultLengthUnit);
             double scale = calcOutputScale(outputUnit);
 
-            if (Utilities::hasFileExt(file_name, "brp") || Utilities::hasFileExt(file_name, "brep"))
+            if (OccUtils::isBrepFile(file_name))
             {
                 exportCompound(file_name, scale);
                 return true;
             }
             else if (Utilities::hasFileExt(file_name, "stp") || Utilities::hasFileExt(file_name, "step"))
             {
+                /// XCAF application and Interface_Static parameters are global, while this writer may run
+                /// in background with the reader of next input, so the exclusive lock is held only to create
+                /// and close the document and to set and restore parameters. `write.step.*` parameters are
+                /// not used by readers, but shared by writers, so writers are serialized by another mutex.
+                std::lock_guard<std::mutex> writerLock(stepWriterMutex());
+                std::unique_lock<std::shared_mutex> exchangeLock(OccUtils::dataExchangeMutex());
                 // LOG_F(INFO, "export Dataset pointed by member hDoc");
                 Handle(TDocStd_Document) aDoc = createDocument(scale);
 
@@ -175,7 +216,11 @@ namespace Geom
                 STEPControl_StepModelType mode = STEPControl_AsIs;
                 // recommended value, others shape mode are available
                 // Interface_Static::SetCVal("write.step.schema", "AP214IS");
-                Interface_Static::SetIVal("write.step.assembly", 1); // global variable
+                // global variables, restored after writing, otherwise later reading will be scaled
+                const int assemblyMode = Interface_Static::IVal("write.step.assembly");
+                const std::string cascadeUnit = Interface_Static::CVal("xstep.cascade.unit");
+                const std::string stepUnit = Interface_Static::CVal("write.step.unit");
+                Interface_Static::SetIVal("write.step.assembly", 1);
                 // Interface_Static::SetIVal ("write.step.nonmanifold", 1);
                 // "write.precision.val" = 0.0001 is the default value
 
@@ -186,6 +231,8 @@ namespace Geom
                     // all vertex coordinate will not be scaled during writing out, change unit,
                     // but it causes scaling at reading back
                 }
+                else
+                    exchangeLock.unlock(); // `xstep.cascade.unit` used by readers is not changed
 
                 STEPCAFControl_Writer writer(WS, scratch);
                 // this writer contains a STEPControl_Writer class, not by inheritance
@@ -196,6 +243,13 @@ namespace Geom
                 }
 
                 IFSelect_ReturnStatus stat = writer.Write(file_name.c_str());
+
+                if (not exchangeLock.owns_lock())
+                    exchangeLock.lock();
+                Interface_Static::SetIVal("write.step.assembly", assemblyMode);
+                Interface_Static::SetCVal("xstep.cascade.unit", cascadeUnit.c_str());
+                Interface_Static::SetCVal("write.step.unit", stepUnit.c_str());
+                XCAFApp_Application::GetApplication()->Close(aDoc);
                 return (IFSelect_RetDone == stat);
             }
             else
@@ -207,6 +261,14 @@ namespace Geom
             return false;
         }
 
+        /// serialize STEP writers, which share global `write.step.*` parameters
+        static std::mutex& stepWriterMutex()
+        {
+            static std::mutex m;
+            return m;
+        }
+
+        /// caller must hold `OccUtils::dataExchangeMutex()` exclusively and close the returned document
         Handle(TDocStd_Document) createDocument(double scale = 1)
         {
 
@@ -219,24 +281,22 @@ namespace Geom
             Handle(XCAFDoc_ColorTool) colorTool = XCAFDoc_DocumentTool::ColorTool(newDoc->Main());
             Handle(XCAFDoc_MaterialTool) materialTool = XCAFDoc_DocumentTool::MaterialTool(newDoc->Main());
 
-            auto myColorMap = myInputData->get<MapType<Standard_Integer, Quantity_Color>>("myColorMap");
-            auto myNameMap = myInputData->get<MapType<Standard_Integer, std::string>>("myNameMap");
-            ///  material is not supported yet:  auto myMaterialMap =
+            auto myItemColors = myInputData->getConst<VectorType<std::optional<Quantity_Color>>>("myItemColors");
+            auto myItemNames = myInputData->getConst<VectorType<std::string>>("myItemNames");
+            ///  material is not supported yet:  auto myItemMaterials =
 
             /// see: https://www.opencascade.com/content/exporting-step-assembly-what-am-i-doing-wrong
-            size_t i = 0U;
-            for (auto& item : *mySolids)
-            {
+            const bool skipSuppressed = false; // all items are written into STEP document
+            forEachResultSolid(skipSuppressed, [&](const ItemIndexType i, const TopoDS_Shape& item) {
                 TDF_Label partLabel = shapeTool->NewShape();
                 if (scale != 1)
-                    shapeTool->SetShape(partLabel, OccUtils::scaleShape(item.second, scale));
+                    shapeTool->SetShape(partLabel, OccUtils::scaleShape(item, scale));
                 else
-                    shapeTool->SetShape(partLabel, item.second);
-                colorTool->SetColor(partLabel, (*myColorMap)[item.first], XCAFDoc_ColorGen);
-                TDataStd_Name::Set(partLabel, TCollection_ExtendedString((*myNameMap)[item.first].c_str(), true));
+                    shapeTool->SetShape(partLabel, item);
+                colorTool->SetColor(partLabel, (*myItemColors)[i].value_or(Quantity_Color()), XCAFDoc_ColorGen);
+                TDataStd_Name::Set(partLabel, TCollection_ExtendedString((*myItemNames)[i].c_str(), true));
                 ///  Material not yet supported
-                i++;
-            }
+            });
             shapeTool->UpdateAssemblies(); // OCCT 7.2 will not automatically update, so must explicitly call this func
 
             return newDoc;
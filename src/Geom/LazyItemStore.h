@@ -0,0 +1,197 @@
+// license
+#ifndef PPP_LAZY_ITEM_STORE_H
+#define PPP_LAZY_ITEM_STORE_H
+
+#include "GeometryTypes.h"
+#include "PPP/Logger.h"
+#include "PPP/PreCompiled.h"
+
+
+namespace Geom
+{
+    using namespace PPP;
+
+    /// \ingroup Geom
+    /**
+     * \brief memory-bounded item store, shapes are loaded on demand from a binary shape archive
+     *
+     * All shapes are written once into an archive file in OCCT binary brep format (BinTools),
+     * only the offset of each shape record is kept in memory, indexed by ItemIndexType.
+     * A shape is loaded on the first access and kept in a LRU (least recently used) cache,
+     * once the estimated memory of cached shapes exceeds the budget, cold shapes are evicted.
+     *
+     * Items modified by processors via `setItem()` are pinned in memory and never evicted,
+     * since the archive holds only the original shapes.
+     *
+     * Items are keyed by index only. A shape reloaded after eviction is a new TShape, so its `OccUtils::shapeHash()`
+     * and `IsSame()` differ from the previously loaded copy, the hash assigned at reading must be used instead.
+     *
+     * Thread-safety: cache bookkeeping is protected by a mutex, while shape loading is done outside the lock
+     * and each loading opens its own file stream. Shape is returned by value (a cheap handle copy),
+     * so a shape evicted from cache is still valid for the thread holding it.
+     */
+    class LazyItemStore
+    {
+    private:
+        struct ItemRecord
+        {
+            std::streamoff offset;
+            std::size_t size; /// byte size in the archive, used to estimate memory footprint
+        };
+
+        std::string myArchiveFile;
+        std::size_t myMemoryBudget; /// in bytes
+        std::size_t myMemoryUsage = 0;
+
+        VectorType<ItemRecord> myRecords;
+        VectorType<TopoDS_Shape> myCache; /// Null shape if not loaded
+        VectorType<char> myPinned;        /// std::vector<bool> is avoided for its proxy reference
+        VectorType<char> myCached;
+        std::list<ItemIndexType> myRecentItems; /// most recently used at the front, pinned items are excluded
+        VectorType<std::list<ItemIndexType>::iterator> myRecentPositions;
+
+        std::mutex myMutex;
+
+        /// in-memory BRep data structure is bigger than its binary record, this is a rough ratio
+        static const std::size_t MemoryRatio = 4;
+
+    public:
+        /// @param memoryBudget  memory in bytes for the cached shapes, modified (pinned) items included
+        LazyItemStore(const std::string& archiveFile, std::size_t memoryBudget)
+                : myArchiveFile(archiveFile)
+                , myMemoryBudget(memoryBudget)
+        {
+        }
+
+        LazyItemStore(const LazyItemStore&) = delete;
+        LazyItemStore& operator=(const LazyItemStore&) = delete;
+
+        /// write all shapes into archive in the item index sequence, must be called in serial
+        void build(const ItemVectorType& shapes)
+        {
+            std::ofstream ofs(myArchiveFile, std::ios::out | std::ios::binary | std::ios::trunc);
+            const std::size_t N = shapes.size();
+            myRecords.resize(N);
+            for (std::size_t i = 0; i < N; i++)
+            {
+                myRecords[i].offset = ofs.tellp();
+                BinTools::Write(shapes[i], ofs);
+                myRecords[i].size = static_cast<std::size_t>(ofs.tellp() - myRecords[i].offset);
+            }
+            myCache.resize(N);
+            myPinned.assign(N, 0);
+            myCached.assign(N, 0);
+            myRecentPositions.resize(N);
+            LOG_F(INFO, "%lu shapes are saved into archive `%s` for lazy loading, memory budget %lu MB", N,
+                  myArchiveFile.c_str(), myMemoryBudget / (1024 * 1024));
+        }
+
+        inline std::size_t itemCount() const
+        {
+            return myRecords.size();
+        }
+
+        /// estimated memory of cached and pinned shapes in bytes
+        inline std::size_t memoryUsage() const
+        {
+            return myMemoryUsage;
+        }
+
+        /// get the item shape, load from archive if it is not in cache
+        TopoDS_Shape item(const ItemIndexType index)
+        {
+            {
+                std::lock_guard<std::mutex> lock(myMutex);
+                if (myCached[index])
+                {
+                    touch(index);
+                    return myCache[index];
+                }
+            }
+
+            TopoDS_Shape s = load(index); // time-consuming IO, out of lock
+
+            std::lock_guard<std::mutex> lock(myMutex);
+            if (myCached[index]) // loaded by another thread in the meanwhile
+            {
+                touch(index);
+                return myCache[index];
+            }
+            myCache[index] = s;
+            myCached[index] = 1;
+            myMemoryUsage += estimatedMemory(index);
+            myRecentItems.push_front(index);
+            myRecentPositions[index] = myRecentItems.begin();
+            evict();
+            return s;
+        }
+
+        /// get the item shape for a single pass over all items (e.g. writing), without filling the cache
+        TopoDS_Shape itemUncached(const ItemIndexType index)
+        {
+            {
+                std::lock_guard<std::mutex> lock(myMutex);
+                if (myCached[index])
+                    return myCache[index];
+            }
+            return load(index);
+        }
+
+        /// modified item is pinned in memory, the caller should have locked this item
+        void setItem(const ItemIndexType index, const TopoDS_Shape& newShape)
+        {
+            std::lock_guard<std::mutex> lock(myMutex);
+            if (myCached[index] and not myPinned[index])
+            {
+                myRecentItems.erase(myRecentPositions[index]);
+            }
+            if (not myCached[index])
+            {
+                myMemoryUsage += estimatedMemory(index);
+            }
+            myCache[index] = newShape;
+            myCached[index] = 1;
+            myPinned[index] = 1;
+        }
+
+    private:
+        TopoDS_Shape load(const ItemIndexType index) const
+        {
+            std::ifstream ifs(myArchiveFile, std::ios::in | std::ios::binary);
+            ifs.seekg(myRecords[index].offset);
+            TopoDS_Shape s;
+            BinTools::Read(s, ifs);
+            if (s.IsNull())
+                LOG_F(ERROR, "failed to load item #%lu from shape archive `%s`", index, myArchiveFile.c_str());
+            return s;
+        }
+
+        inline std::size_t estimatedMemory(const ItemIndexType index) const
+        {
+            return myRecords[index].size * MemoryRatio;
+        }
+
+        /// move to the front of LRU list, called within lock
+        inline void touch(const ItemIndexType index)
+        {
+            if (not myPinned[index])
+                myRecentItems.splice(myRecentItems.begin(), myRecentItems, myRecentPositions[index]);
+        }
+
+        /// evict least recently used items until memory usage is within budget, called within lock
+        void evict()
+        {
+            while (myMemoryUsage > myMemoryBudget and myRecentItems.size() > 1)
+            {
+                ItemIndexType i = myRecentItems.back();
+                myRecentItems.pop_back();
+                myCache[i].Nullify();
+                myCached[i] = 0;
+                myMemoryUsage -= estimatedMemory(i);
+            }
+        }
+    };
+
+} // namespace Geom
+
+#endif
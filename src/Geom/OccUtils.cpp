@@ -33,6 +33,8 @@
 // from Salome Geom module
 #include <GEOMAlgo_Gluer2.hxx>
 
+#include <condition_variable>
+
 namespace Geom
 {
     using namespace PPP;
@@ -41,6 +43,88 @@ namespace Geom
     /* static utility metheds */
     namespace OccUtils
     {
+        /// ask OCCT algorithm to stop by `UserBreak()`, once the deadline has passed
+        class DeadlineIndicator : public Message_ProgressIndicator
+        {
+        private:
+            std::chrono::steady_clock::time_point myDeadline;
+            std::atomic<bool> myFired{false}; // UserBreak() may be called by OCCT internal threads
+
+        public:
+            explicit DeadlineIndicator(const double seconds)
+                    : myDeadline(std::chrono::steady_clock::now() +
+                                 std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                     std::chrono::duration<double>(seconds)))
+            {
+            }
+            virtual Standard_Boolean UserBreak() override
+            {
+                if (std::chrono::steady_clock::now() > myDeadline)
+                    myFired = true;
+                return myFired;
+            }
+            /// whether OCCT has been asked to break
+            bool fired() const
+            {
+                return myFired;
+            }
+#if OCC_VERSION_HEX >= 0x070500
+            virtual void Show(const Message_ProgressScope&, const Standard_Boolean) override
+            {
+            }
+#else
+            virtual Standard_Boolean Show(const Standard_Boolean) override
+            {
+                return Standard_True;
+            }
+#endif
+        };
+
+        /// call it if the algorithm has failed, to tell the break by deadline from other failures
+        void throwIfBroken(const Handle(DeadlineIndicator)& deadline)
+        {
+            if (not deadline.IsNull() and deadline->fired())
+                throw DeadlineExceeded("OCCT algorithm is broken by the deadline");
+        }
+
+        std::shared_mutex& dataExchangeMutex()
+        {
+            static std::shared_mutex m;
+            return m;
+        }
+
+        /// state shared by all `LengthUnitGuard` instances: the unit being translated and the translation count
+        struct LengthUnitState
+        {
+            std::mutex mutex;
+            std::condition_variable released;
+            std::string unit;
+            size_t count = 0;
+        };
+
+        static LengthUnitState& lengthUnitState()
+        {
+            static LengthUnitState state;
+            return state;
+        }
+
+        LengthUnitGuard::LengthUnitGuard(const std::string& unit)
+        {
+            auto& state = lengthUnitState();
+            std::unique_lock<std::mutex> lock(state.mutex);
+            state.released.wait(lock, [&]() { return state.count == 0 or state.unit == unit; });
+            state.unit = unit;
+            state.count++;
+        }
+
+        LengthUnitGuard::~LengthUnitGuard()
+        {
+            auto& state = lengthUnitState();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (--state.count == 0)
+                state.released.notify_all();
+        }
+
         void saveShape(const std::vector<TopoDS_Shape>& shapes, const std::string file_name)
         {
             TopoDS_Builder cBuilder;
@@ -56,6 +140,7 @@ namespace Geom
         /// this function may serve as unit test for GeometryWriter
         void saveAssemblyToStepFile(const TopoDS_Shape& shape, const std::string file_name)
         {
+            std::unique_lock<std::shared_mutex> exchangeLock(dataExchangeMutex());
             Handle(XCAFApp_Application) hApp = XCAFApp_Application::GetApplication();
             Handle(TDocStd_Document) aDoc;
             hApp->NewDocument(TCollection_ExtendedString("MDTV-CAF"), aDoc);
@@ -72,21 +157,23 @@ namespace Geom
             STEPCAFControl_Writer writer;
             writer.Transfer(aDoc, STEPControl_AsIs);
             writer.Write(file_name.c_str());
+            hApp->Close(aDoc);
         }
 
         void saveShape(const TopoDS_Shape& shape, const std::string file_name)
         {
             if (Utilities::hasFileExt(file_name, "step") || Utilities::hasFileExt(file_name, "stp"))
             {
+                std::shared_lock<std::shared_mutex> exchangeLock(dataExchangeMutex());
                 STEPControl_Writer aWriter;
                 IFSelect_ReturnStatus aStat = aWriter.Transfer(shape, STEPControl_AsIs);
                 aStat = aWriter.Write(file_name.c_str());
                 if (aStat != IFSelect_RetDone)
                     std::cout << "Step file writing error" << std::endl;
             }
-            else if (Utilities::hasFileExt(file_name, "brep") || Utilities::hasFileExt(file_name, "brp"))
+            else if (isBrepFile(file_name))
             {
-                BRepTools::Write(shape, file_name.c_str());
+                writeBrep(shape, file_name);
             }
             else
             {
@@ -94,23 +181,70 @@ namespace Geom
             }
         }
 
+        bool isBinaryBrepFile(const std::string& file_name)
+        {
+            return Utilities::hasFileExt(file_name, "bbrep");
+        }
+
+        /// splitmix64 finalizer to spread the bits of TShape address which are aligned
+        inline std::uint64_t mixHash(std::uint64_t z)
+        {
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        ItemHashType shapeHash(const TopoDS_Shape& s)
+        {
+            std::uint64_t h = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(s.TShape().get()));
+            std::uint64_t l = static_cast<std::uint64_t>(s.Location().HashCode(IntegerLast()));
+            return mixHash(mixHash(h) ^ l);
+        }
+
+        bool isBrepFile(const std::string& file_name)
+        {
+            return Utilities::hasFileExt(file_name, "brep") || Utilities::hasFileExt(file_name, "brp") ||
+                   isBinaryBrepFile(file_name);
+        }
+
+        /// binary format is much faster to write and read, and smaller in size, for large assemblies
+        bool writeBrep(const TopoDS_Shape& shape, const std::string& file_name)
+        {
+            if (isBinaryBrepFile(file_name))
+                return BinTools::Write(shape, file_name.c_str());
+            else
+                return BRepTools::Write(shape, file_name.c_str()); //  progress reporter can be the last arg
+        }
+
+        TopoDS_Shape readBrep(const std::string& file_name)
+        {
+            TopoDS_Shape shape;
+            if (isBinaryBrepFile(file_name))
+            {
+                BinTools::Read(shape, file_name.c_str());
+            }
+            else
+            {
+                BRep_Builder cBuilder;
+                BRepTools::Read(shape, file_name.c_str(), cBuilder);
+            }
+            if (shape.IsNull())
+                throw std::runtime_error("brep read data is Null for:" + file_name);
+            return shape;
+        }
+
         TopoDS_Shape loadShape(const std::string file_name)
         {
             if (not fs::exists(file_name))
                 throw std::runtime_error("file not exist" + file_name);
 
-            if (Utilities::hasFileExt(file_name, "brep") || Utilities::hasFileExt(file_name, "brp"))
+            if (isBrepFile(file_name))
             {
-                BRep_Builder cBuilder;
-                TopoDS_Shape shape;
-
-                BRepTools::Read(shape, file_name.c_str(), cBuilder);
-                if (shape.IsNull())
-                    throw std::runtime_error("brep read data is Null for:" + file_name);
-                return shape;
+                return readBrep(file_name);
             }
             else if (Utilities::hasFileExt(file_name, "step") || Utilities::hasFileExt(file_name, "stp"))
             {
+                std::shared_lock<std::shared_mutex> exchangeLock(dataExchangeMutex());
                 STEPControl_Reader aReader;
                 IFSelect_ReturnStatus stat = aReader.ReadFile(file_name.c_str());
 
@@ -143,12 +277,15 @@ namespace Geom
             }
         }
 
-        TopoDS_Shape loadShape(std::shared_ptr<std::stringstream> ss)
+        TopoDS_Shape loadShape(std::shared_ptr<std::stringstream> ss, const std::string& fileType)
         {
             BRep_Builder cBuilder;
             TopoDS_Shape shape;
 
-            BRepTools::Read(shape, (*ss.get()), cBuilder);
+            if (fileType == "bbrep")
+                BinTools::Read(shape, (*ss.get()));
+            else
+                BRepTools::Read(shape, (*ss.get()), cBuilder);
             return shape;
         }
 
@@ -327,6 +464,10 @@ namespace Geom
             {
                 BRepTools::Write(merged, (*ss.get()));
             }
+            else if (su == "bbrep")
+            {
+                BinTools::Write(merged, (*ss.get()));
+            }
             else if (su == "stl")
             {
                 StlAPI_Writer STLwriter;
@@ -347,8 +488,8 @@ namespace Geom
         }
 
 
-        TopoDS_Compound createCompound(const ItemContainerType theSolids,
-                                       std::shared_ptr<const MapType<ItemHashType, ShapeErrorType>> suppressed)
+        TopoDS_Compound createCompound(const ItemVectorType& theSolids,
+                                       std::shared_ptr<const VectorType<ShapeErrorType>> suppressed)
         {
             TopoDS_Builder cBuilder;
             TopoDS_Compound merged;
@@ -358,13 +499,13 @@ namespace Geom
             {
                 if (suppressed)
                 {
-                    bool itemSuppressed = (*suppressed).at(item.first) != ShapeErrorType::NoError;
+                    bool itemSuppressed = (*suppressed).at(i) != ShapeErrorType::NoError;
                     if (not itemSuppressed)
-                        cBuilder.Add(merged, item.second);
+                        cBuilder.Add(merged, item);
                 }
                 else
                 {
-                    cBuilder.Add(merged, item.second);
+                    cBuilder.Add(merged, item);
                 }
                 i++;
             }
@@ -372,8 +513,8 @@ namespace Geom
             return merged;
         }
 
-        TopoDS_CompSolid createCompSolid(const ItemContainerType theSolids,
-                                         std::shared_ptr<const MapType<ItemHashType, ShapeErrorType>> suppressed)
+        TopoDS_CompSolid createCompSolid(const ItemVectorType& theSolids,
+                                         std::shared_ptr<const VectorType<ShapeErrorType>> suppressed)
         {
             TopoDS_Builder cBuilder;
             // TopoDS_Shape* merged;
@@ -384,13 +525,13 @@ namespace Geom
             {
                 if (suppressed)
                 {
-                    bool itemSuppressed = (*suppressed).at(item.first) != ShapeErrorType::NoError;
+                    bool itemSuppressed = (*suppressed).at(i) != ShapeErrorType::NoError;
                     if (not itemSuppressed)
-                        cBuilder.Add(merged, item.second);
+                        cBuilder.Add(merged, item);
                 }
                 else
                 {
-                    cBuilder.Add(merged, item.second);
+                    cBuilder.Add(merged, item);
                 }
                 i++;
             }
@@ -681,16 +822,10 @@ namespace Geom
             }
         }
 
-        /// mkGFA reference itself is input and output parameter, can merge more than 2 solids
-        std::vector<TopoDS_Shape> generalFuse(const std::vector<TopoDS_Shape>& shapes, const Standard_Real tolerance,
-                                              std::shared_ptr<BRepAlgoAPI_BuilderAlgo> mkGFA)
+        /// arguments of general fuse, shapes are copied if fuzzy tolerance is used
+        static TopTools_ListOfShape generalFuseArguments(const std::vector<TopoDS_Shape>& shapes,
+                                                         const Standard_Real tol)
         {
-            if (not mkGFA)
-            {
-                mkGFA = std::make_shared<BRepAlgoAPI_BuilderAlgo>();
-                mkGFA->SetRunParallel(false);
-            }
-            auto tol = tolerance; // set 0.0 to temporally disable fuzzy operation
             TopTools_ListOfShape GFAArguments;
             for (const TopoDS_Shape& it : shapes)
             {
@@ -702,6 +837,20 @@ namespace Geom
                 else
                     GFAArguments.Append(it);
             }
+            return GFAArguments;
+        }
+
+        /// mkGFA reference itself is input and output parameter, can merge more than 2 solids
+        std::vector<TopoDS_Shape> generalFuse(const std::vector<TopoDS_Shape>& shapes, const Standard_Real tolerance,
+                                              std::shared_ptr<BRepAlgoAPI_BuilderAlgo> mkGFA, const double timeBudget)
+        {
+            if (not mkGFA)
+            {
+                mkGFA = std::make_shared<BRepAlgoAPI_BuilderAlgo>();
+                mkGFA->SetRunParallel(false);
+            }
+            auto tol = tolerance; // set 0.0 to temporally disable fuzzy operation
+            TopTools_ListOfShape GFAArguments = generalFuseArguments(shapes, tol);
             mkGFA->SetArguments(GFAArguments);
             if (tol > 0.0)
                 mkGFA->SetFuzzyValue(tolerance);
@@ -711,9 +860,34 @@ namespace Geom
 #if OCC_VERSION_HEX >= 0x070300
             mkGFA->SetUseOBB(true);
 #endif
-            mkGFA->Build();
+            Handle(DeadlineIndicator) deadline;
+            if (timeBudget > 0.0)
+                deadline = new DeadlineIndicator(timeBudget);
+            try
+            {
+#if OCC_VERSION_HEX >= 0x070500
+                if (not deadline.IsNull())
+                    mkGFA->Build(deadline->Start());
+                else
+                    mkGFA->Build();
+#else
+#if OCC_VERSION_HEX >= 0x070300
+                if (not deadline.IsNull())
+                    mkGFA->SetProgressIndicator(deadline);
+#endif
+                mkGFA->Build();
+#endif
+            }
+            catch (...)
+            {
+                throwIfBroken(deadline);
+                throw;
+            }
             if (!mkGFA->IsDone())
+            {
+                throwIfBroken(deadline);
                 throw OSD_Exception("General Fusion failed");
+            }
 
             std::vector<TopoDS_Shape> res; // output is limited to Solid shape type
             for (TopExp_Explorer anExp(mkGFA->Shape(), TopAbs_SOLID); anExp.More(); anExp.Next())
@@ -723,6 +897,106 @@ namespace Geom
             return res;
         }
 
+        std::vector<TopoDS_Shape> generalFuseInPhases(const std::vector<TopoDS_Shape>& shapes,
+                                                      const Standard_Real tolerance,
+                                                      std::shared_ptr<BRepAlgoAPI_BuilderAlgo>& mkGFA,
+                                                      double& intersectionTime, double& buildingTime,
+                                                      const double timeBudget)
+        {
+            typedef std::chrono::steady_clock ClockType;
+            const bool runParallel = mkGFA ? mkGFA->RunParallel() : false;
+#if OCC_VERSION_HEX >= 0x070300
+            TopTools_ListOfShape GFAArguments = generalFuseArguments(shapes, tolerance);
+            auto filler = std::make_shared<BOPAlgo_PaveFiller>();
+            filler->SetArguments(GFAArguments);
+            filler->SetRunParallel(runParallel);
+            if (tolerance > 0.0)
+                filler->SetFuzzyValue(tolerance);
+            filler->SetNonDestructive(Standard_True);
+            filler->SetUseOBB(Standard_True);
+            // one deadline for both phases
+            Handle(DeadlineIndicator) deadline;
+            if (timeBudget > 0.0)
+                deadline = new DeadlineIndicator(timeBudget);
+
+            auto start = ClockType::now();
+            try
+            {
+#if OCC_VERSION_HEX >= 0x070500
+                if (not deadline.IsNull())
+                    filler->Perform(deadline->Start());
+                else
+                    filler->Perform();
+#else
+                if (not deadline.IsNull())
+                    filler->SetProgressIndicator(deadline);
+                filler->Perform();
+#endif
+            }
+            catch (...)
+            {
+                throwIfBroken(deadline);
+                throw;
+            }
+            intersectionTime += std::chrono::duration<double>(ClockType::now() - start).count();
+            if (filler->HasErrors())
+            {
+                throwIfBroken(deadline);
+                throw OSD_Exception("General Fusion failed in intersection");
+            }
+
+            // builder keeps a raw pointer to the filler, so the deleter holds the filler till the builder is gone
+            mkGFA.reset(new BRepAlgoAPI_BuilderAlgo(*filler), [filler](BRepAlgoAPI_BuilderAlgo* p) { delete p; });
+            mkGFA->SetArguments(GFAArguments);
+            mkGFA->SetRunParallel(runParallel);
+            if (tolerance > 0.0)
+                mkGFA->SetFuzzyValue(tolerance);
+            mkGFA->SetNonDestructive(Standard_True);
+
+            start = ClockType::now();
+            // building only, intersection has been done by the filler
+            try
+            {
+#if OCC_VERSION_HEX >= 0x070500
+                if (not deadline.IsNull())
+                    mkGFA->Build(deadline->Start());
+                else
+                    mkGFA->Build();
+#else
+                if (not deadline.IsNull())
+                    mkGFA->SetProgressIndicator(deadline);
+                mkGFA->Build();
+#endif
+            }
+            catch (...)
+            {
+                throwIfBroken(deadline);
+                throw;
+            }
+            buildingTime += std::chrono::duration<double>(ClockType::now() - start).count();
+            if (!mkGFA->IsDone())
+            {
+                throwIfBroken(deadline);
+                throw OSD_Exception("General Fusion failed");
+            }
+
+            std::vector<TopoDS_Shape> res; // output is limited to Solid shape type
+            for (TopExp_Explorer anExp(mkGFA->Shape(), TopAbs_SOLID); anExp.More(); anExp.Next())
+            {
+                res.push_back(anExp.Current());
+            }
+            return res;
+#else
+            // the filler can not be set up with the same options, both phases are counted as building
+            if (not mkGFA)
+                mkGFA = std::make_shared<BRepAlgoAPI_BuilderAlgo>();
+            const auto start = ClockType::now();
+            auto res = generalFuse(shapes, tolerance, mkGFA, timeBudget);
+            buildingTime += std::chrono::duration<double>(ClockType::now() - start).count();
+            return res;
+#endif
+        }
+
         TopoDS_Shape fuseShape(const VectorType<TopoDS_Shape> v, bool occInternalParallel)
         {
             assert(v.size() >= 2UL);
@@ -26,6 +26,8 @@
 #include "OpenCascadeAll.h"
 #include "PPP/PreCompiled.h"
 
+#include <shared_mutex>
+
 
 namespace Geom
 {
@@ -36,17 +38,50 @@ namespace Geom
      */
     namespace OccUtils
     {
-        /// save shape to brep file
+        /** process-wide lock of OCCT data exchange state, i.e. the `XCAFApp_Application` singleton and
+         * the `Interface_Static` translation parameters, which are not thread-safe.
+         * Lock it exclusively (`std::unique_lock`) around `NewDocument()`/`Close()` and `Interface_Static` setters,
+         * shared (`std::shared_lock`) around STEP/IGES translation which reads those parameters.
+         * It is not recursive, a thread must not lock it again while holding it.
+         */
+        GeomExport std::shared_mutex& dataExchangeMutex();
+
+        /** OCCT STEP translation sets process-wide length factors (`UnitsMethods`) from the unit of the file,
+         * translations of files in the same length unit can run concurrently, as they set the same factors,
+         * but translation of a file in another unit waits until they have finished.
+         * Hold it around unit setup and transfer, before locking `dataExchangeMutex()`.
+         */
+        class GeomExport LengthUnitGuard
+        {
+        public:
+            explicit LengthUnitGuard(const std::string& unit);
+            ~LengthUnitGuard();
+            LengthUnitGuard(const LengthUnitGuard&) = delete;
+            LengthUnitGuard& operator=(const LengthUnitGuard&) = delete;
+        };
+
+        /// save shape to brep file, OCCT binary brep format is selected by file suffix `.bbrep`
         GeomExport void saveShape(const std::vector<TopoDS_Shape>& shapes, const std::string file_name);
         GeomExport void saveShape(const TopoDS_Shape& shape, const std::string file_name);
 
+        /// @{ brep IO, text format by `BRepTools` or binary format by `BinTools` if file suffix is `.bbrep`
+        GeomExport bool isBinaryBrepFile(const std::string& file_name);
+        GeomExport bool isBrepFile(const std::string& file_name);
+        GeomExport bool writeBrep(const TopoDS_Shape& shape, const std::string& file_name);
+        GeomExport TopoDS_Shape readBrep(const std::string& file_name);
+        /// @}
+
+        /// 64bit hash from TShape address and location, same value for shapes `IsSame()`, orientation ignored
+        GeomExport ItemHashType shapeHash(const TopoDS_Shape& s);
+
         /// save to buffer in memory, avoid disk IO, to be sent over network
-        /// is there any Endianness issue for utf8 text stream?
+        /// is there any Endianness issue for utf8 text stream? fileType "bbrep" for binary brep
         GeomExport std::shared_ptr<std::stringstream> saveShapeToStream(const std::vector<TopoDS_Shape>& shapes,
                                                                         const std::string& fileType = "brep");
 
         GeomExport TopoDS_Shape loadShape(const std::string file_name);
-        GeomExport TopoDS_Shape loadShape(std::shared_ptr<std::stringstream> stream);
+        GeomExport TopoDS_Shape loadShape(std::shared_ptr<std::stringstream> stream,
+                                          const std::string& fileType = "brep");
 
         /// this API will not count on shared geometry, like shared faces in a compsolid
         GeomExport unsigned long countSubShapes(const TopoDS_Shape& _shape, const TopAbs_ShapeEnum Type);
@@ -66,12 +101,12 @@ namespace Geom
         GeomExport TopoDS_Shape glueFaces(const TopoDS_Shape& _shape, const Standard_Real tolerance = 0.0);
 
 
-        GeomExport TopoDS_Compound
-        createCompound(const ItemContainerType theSolids,
-                       std::shared_ptr<const MapType<ItemHashType, ShapeErrorType>> suppressed = nullptr);
+        /// item i is skipped if `(*suppressed)[i] != ShapeErrorType::NoError`, nullptr means no item is suppressed
+        GeomExport TopoDS_Compound createCompound(const ItemVectorType& theSolids,
+                                                  std::shared_ptr<const VectorType<ShapeErrorType>> suppressed);
         GeomExport TopoDS_CompSolid
-        createCompSolid(const ItemContainerType theSolids,
-                        std::shared_ptr<const MapType<ItemHashType, ShapeErrorType>> suppressed = nullptr);
+        createCompSolid(const ItemVectorType& theSolids,
+                        std::shared_ptr<const VectorType<ShapeErrorType>> suppressed = nullptr);
         GeomExport TopoDS_Shape createCompound(std::vector<TopoDS_Shape> shapes);
 
 
@@ -101,12 +136,32 @@ namespace Geom
         int countModifiedShape(const std::shared_ptr<BRepAlgoAPI_BuilderAlgo>& mkGFA, TopAbs_ShapeEnum stype);
         GeomExport void summarizeBuilderAlgo(std::shared_ptr<BRepAlgoAPI_BuilderAlgo> mkGFA);
 
+        /// thrown by `generalFuse()` if OCCT has actually been broken by the deadline of `timeBudget`
+        class DeadlineExceeded : public std::runtime_error
+        {
+        public:
+            using std::runtime_error::runtime_error;
+        };
+
         /** boolean fragments
          * the caller has full control on multiple threading the `builder` pointer
-         * internal multiple thread can be turn off: internalMultiThreading = false */
+         * internal multiple thread can be turn off: internalMultiThreading = false
+         * if `timeBudget` (seconds) is positive, OCCT is asked to break by `UserBreak()` after that time,
+         * then `DeadlineExceeded` is thrown, other failures throw OSD_Exception,
+         * OCCT older than 7.3 does not support it */
         GeomExport std::vector<TopoDS_Shape> generalFuse(const std::vector<TopoDS_Shape>& shapes,
                                                          const Standard_Real tolerance,
-                                                         std::shared_ptr<BRepAlgoAPI_BuilderAlgo> builder);
+                                                         std::shared_ptr<BRepAlgoAPI_BuilderAlgo> builder,
+                                                         const double timeBudget = 0.0);
+        /** boolean fragments with an explicit `BOPAlgo_PaveFiller`, to time intersection and building separately
+         * options (RunParallel, NonDestructive) are taken from the input `builder`, which is then replaced by
+         * a builder bound to the filler, wall time in seconds of each phase is added to the last 2 parameters.
+         * The returned builder owns the filler, as history queries need the data structure of the filler.  */
+        GeomExport std::vector<TopoDS_Shape> generalFuseInPhases(const std::vector<TopoDS_Shape>& shapes,
+                                                                 const Standard_Real tolerance,
+                                                                 std::shared_ptr<BRepAlgoAPI_BuilderAlgo>& builder,
+                                                                 double& intersectionTime, double& buildingTime,
+                                                                 const double timeBudget = 0.0);
         GeomExport TopoDS_Shape commonShape(const VectorType<TopoDS_Shape> v, bool occInternalParallel = true);
         GeomExport TopoDS_Shape fuseShape(const VectorType<TopoDS_Shape> v, bool occInternalParallel = true);
         GeomExport TopoDS_Shape cutShape(const TopoDS_Shape& from, const TopoDS_Shape& substractor);
@@ -89,6 +89,7 @@
 
 // operation system service
 #include <OSD_Exception.hxx>
+#include <OSD_MemInfo.hxx>
 
 // geometry primitive
 #include <gp_Ax1.hxx>
@@ -217,6 +218,10 @@
 #include <Law_Constant.hxx>
 #include <MMgt_TShared.hxx>
 #include <Message_MsgFile.hxx>
+#include <Message_ProgressIndicator.hxx>
+#if OCC_VERSION_HEX >= 0x070500
+#include <Message_ProgressScope.hxx>
+#endif
 #include <Precision.hxx>
 
 #include <BRepBndLib.hxx>
@@ -411,6 +416,8 @@
 #include <BOPAlgo_ArgumentAnalyzer.hxx>
 #include <BOPAlgo_ListOfCheckResult.hxx>
 #endif
+#include <BOPAlgo_PaveFiller.hxx>
+#include <BRepAlgoAPI_BuilderAlgo.hxx>
 
 
 // most of common quantities like Force exist
@@ -482,6 +489,7 @@
 #include <StlAPI_Writer.hxx>
 
 #include <Interface_EntityIterator.hxx>
+#include <Interface_InterfaceModel.hxx>
 #include <Interface_Static.hxx>
 
 #include <Transfer_FinderProcess.hxx>
@@ -496,6 +504,7 @@
 
 #include <STEPConstruct.hxx>
 #include <STEPConstruct_Styles.hxx>
+#include <STEPControl_ActorRead.hxx>
 #include <STEPControl_Controller.hxx>
 #include <STEPControl_Reader.hxx>
 #include <STEPControl_Writer.hxx>
@@ -503,6 +512,8 @@
 #include <StepBasic_ProductDefinition.hxx>
 #include <StepBasic_ProductDefinitionFormation.hxx>
 #include <StepData_StepModel.hxx>
+#include <StepGeom_GeomRepContextAndGlobUnitAssCtxAndGlobUncertaintyAssCtx.hxx>
+#include <StepGeom_GeometricRepresentationContextAndGlobalUnitAssignedContext.hxx>
 #include <StepRepr_AssemblyComponentUsage.hxx>
 #include <StepRepr_CharacterizedDefinition.hxx>
 #include <StepRepr_ProductDefinitionShape.hxx>
@@ -0,0 +1,191 @@
+// license
+#ifndef PPP_ORIENTED_BOUND_BOX_ARRAY_H
+#define PPP_ORIENTED_BOUND_BOX_ARRAY_H
+
+#include "GeometryTypes.h"
+
+namespace Geom
+{
+    using namespace PPP;
+
+    /// \ingroup Geom
+    /**
+     * \brief packed oriented bound boxes (OBB) of all items, one contiguous column per scalar
+     *
+     * Each OBB is its center, 3 unit axes and 3 half sizes, 15 scalars in total.
+     * `separatedMask()` runs the separating axis theorem (SAT) of one box against many boxes, all 15 axes
+     * (3 + 3 face normals, 9 edge cross products) are evaluated without early exit, so that the loop
+     * can be vectorized by compiler. Compared with `Bnd_OBB::IsOut()`, a clearance margin is supported:
+     * two boxes are separated only if the gap along any separating axis is bigger than the clearance.
+     *
+     * It is used as a tighter broad-phase filter after the AABB test of `BoundBoxArray`.
+     */
+    class OrientedBoundBoxArray
+    {
+    public:
+        static const std::size_t Dim = 3;
+        /// added to |cos| of axis angles, to deal with nearly parallel edges, the same idea as in `Bnd_OBB`
+        static constexpr double Epsilon = 1e-10;
+
+    private:
+        VectorType<double> myCenters[Dim];
+        VectorType<double> myAxes[Dim][Dim]; /// myAxes[a][d] is the d-th component of the a-th axis
+        VectorType<double> myHalfSizes[Dim];
+        VectorType<char> myValid; /// void box is always separated
+
+    public:
+        OrientedBoundBoxArray() = default;
+
+#if OCC_VERSION_HEX >= 0x070300
+        explicit OrientedBoundBoxArray(const VectorType<Bnd_OBB>& boxes)
+        {
+            resize(boxes.size());
+            for (std::size_t i = 0; i < boxes.size(); i++)
+                set(i, boxes[i]);
+        }
+
+        void set(const ItemIndexType i, const Bnd_OBB& b)
+        {
+            myValid[i] = not b.IsVoid();
+            if (not myValid[i])
+                return;
+            const gp_XYZ axes[Dim] = {b.XDirection(), b.YDirection(), b.ZDirection()};
+            const double halfSizes[Dim] = {b.XHSize(), b.YHSize(), b.ZHSize()};
+            for (std::size_t a = 0; a < Dim; a++)
+            {
+                myCenters[a][i] = b.Center().Coord(int(a + 1));
+                myHalfSizes[a][i] = halfSizes[a];
+                for (std::size_t d = 0; d < Dim; d++)
+                    myAxes[a][d][i] = axes[a].Coord(int(d + 1));
+            }
+        }
+#endif
+
+        void resize(const std::size_t n)
+        {
+            for (std::size_t a = 0; a < Dim; a++)
+            {
+                myCenters[a].resize(n, 0.0);
+                myHalfSizes[a].resize(n, 0.0);
+                for (std::size_t d = 0; d < Dim; d++)
+                    myAxes[a][d].resize(n, 0.0);
+            }
+            myValid.resize(n, 0);
+        }
+
+        inline std::size_t size() const
+        {
+            return myValid.size();
+        }
+
+        /// set by center, unit axes (row-major, axes[a][d]) and half sizes, mainly for unit test
+        void set(const ItemIndexType i, const double center[Dim], const double axes[Dim][Dim],
+                 const double halfSizes[Dim])
+        {
+            myValid[i] = 1;
+            for (std::size_t a = 0; a < Dim; a++)
+            {
+                myCenters[a][i] = center[a];
+                myHalfSizes[a][i] = halfSizes[a];
+                for (std::size_t d = 0; d < Dim; d++)
+                    myAxes[a][d][i] = axes[a][d];
+            }
+        }
+
+        /**
+         * SAT test of box i against the boxes of given items, mask[k] = 1 if box i and box of items[k] are
+         * separated by a distance bigger than clearance along any of the 15 candidate axes.
+         * @return the count of separated boxes
+         */
+        std::size_t separatedMask(const ItemIndexType i, const ItemIndexType* items, const std::size_t n,
+                                  const double clearance, char* mask) const
+        {
+            double ca[Dim], ha[Dim], A[Dim][Dim];
+            for (std::size_t a = 0; a < Dim; a++)
+            {
+                ca[a] = myCenters[a][i];
+                ha[a] = myHalfSizes[a][i];
+                for (std::size_t d = 0; d < Dim; d++)
+                    A[a][d] = myAxes[a][d][i];
+            }
+            const double c = clearance;
+
+            std::size_t count = 0;
+            for (std::size_t k = 0; k < n; k++)
+            {
+                const ItemIndexType j = items[k];
+                // R[a][b] = A_a . B_b, and T (center distance) in the frame of box i
+                double R[Dim][Dim], AbsR[Dim][Dim], t[Dim];
+                double T[Dim];
+                for (std::size_t d = 0; d < Dim; d++)
+                    T[d] = myCenters[d][j] - ca[d];
+                for (std::size_t a = 0; a < Dim; a++)
+                {
+                    t[a] = T[0] * A[a][0] + T[1] * A[a][1] + T[2] * A[a][2];
+                    for (std::size_t b = 0; b < Dim; b++)
+                    {
+                        R[a][b] = A[a][0] * myAxes[b][0][j] + A[a][1] * myAxes[b][1][j] + A[a][2] * myAxes[b][2][j];
+                        AbsR[a][b] = std::abs(R[a][b]) + Epsilon;
+                    }
+                }
+                const double hb[Dim] = {myHalfSizes[0][j], myHalfSizes[1][j], myHalfSizes[2][j]};
+
+                bool separated = false;
+                for (std::size_t a = 0; a < Dim; a++) // face normals of box i
+                {
+                    const double rb = hb[0] * AbsR[a][0] + hb[1] * AbsR[a][1] + hb[2] * AbsR[a][2];
+                    separated |= std::abs(t[a]) > ha[a] + rb + c;
+                }
+                for (std::size_t b = 0; b < Dim; b++) // face normals of box j
+                {
+                    const double ra = ha[0] * AbsR[0][b] + ha[1] * AbsR[1][b] + ha[2] * AbsR[2][b];
+                    const double tb = t[0] * R[0][b] + t[1] * R[1][b] + t[2] * R[2][b];
+                    separated |= std::abs(tb) > ra + hb[b] + c;
+                }
+                for (std::size_t a = 0; a < Dim; a++) // edge cross products A_a x B_b, not unit vector
+                {
+                    const std::size_t a1 = (a + 1) % Dim, a2 = (a + 2) % Dim;
+                    for (std::size_t b = 0; b < Dim; b++)
+                    {
+                        const std::size_t b1 = (b + 1) % Dim, b2 = (b + 2) % Dim;
+                        const double ra = ha[a1] * AbsR[a2][b] + ha[a2] * AbsR[a1][b];
+                        const double rb = hb[b1] * AbsR[a][b2] + hb[b2] * AbsR[a][b1];
+                        const double tab = t[a2] * R[a1][b] - t[a1] * R[a2][b];
+                        // clearance is scaled by the length of cross product, |A_a x B_b| = sin(angle)
+                        const double len = std::sqrt(std::max(1.0 - R[a][b] * R[a][b], 0.0));
+                        separated |= std::abs(tab) > ra + rb + c * len;
+                    }
+                }
+                const char m = separated | not(myValid[i] & myValid[j]);
+                mask[k] = m;
+                count += m;
+            }
+            return count;
+        }
+
+        /// remove items separated from item i with the clearance, keeping the order of the rest
+        void removeSeparated(const ItemIndexType i, VectorType<ItemIndexType>& items, const double clearance) const
+        {
+            VectorType<char> mask(items.size());
+            separatedMask(i, items.data(), items.size(), clearance, mask.data());
+            std::size_t k = 0;
+            for (std::size_t m = 0; m < items.size(); m++)
+            {
+                items[k] = items[m];
+                k += not mask[m];
+            }
+            items.resize(k);
+        }
+
+        /// single pair test
+        bool overlapped(const ItemIndexType i, const ItemIndexType j, const double clearance) const
+        {
+            char m;
+            separatedMask(i, &j, 1, clearance, &m);
+            return not m;
+        }
+    };
+
+} // namespace Geom
+
+#endif
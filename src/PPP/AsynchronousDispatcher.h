@@ -47,8 +47,10 @@ namespace PPP
             std::vector<indexer> a;
             try
             {
+                const auto start = std::chrono::steady_clock::now();
                 /// NOTE: std::scoped_lock in C++17 can lock 2 locks without deadlock
                 std::lock_guard<std::mutex> lock(myMutex); // this lock is exception-safe
+                recordLockWait(start);
                 if (prevLocked.size() > 0)
                 {
                     unlock(prevLocked); /// move this out, make this function const?
@@ -60,6 +62,7 @@ namespace PPP
                     produce(myItemCount * myBatchSize * myWorkerCount);
                 }
                 a = consume(myBatchSize);
+                recordDispatch(start, a.size());
             }
             catch (const std::exception& e)
             {
@@ -85,6 +88,7 @@ namespace PPP
 
         void produce(const ItemIndexType nProducts)
         {
+            size_t produced = 0, skipped = 0;
             auto it = myRemainedItems.cbegin();
             const auto& iend = myRemainedItems.cend();
             for (ItemIndexType i = 0; i < nProducts; i++)
@@ -92,14 +96,17 @@ namespace PPP
                 while (it != iend && isLocked(*it))
                 {
                     it++;
+                    skipped++;
                 }
                 if (it != iend)
                 {
                     myQueue.push(*it);
                     lockItem(*it);
                     it++;
+                    produced++;
                 }
             }
+            recordScan(produced + skipped, skipped);
         }
     };
 } // namespace PPP
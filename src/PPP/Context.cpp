@@ -36,9 +36,18 @@ void Context::initialize(int argc, char** argv)
     }
 #endif
     std::string input_file = "../python/config.json";
-    const char* USAGE = "Usage: program input_config_file \n mpirun -np 2 program input_config_file";
+    const char* USAGE = "Usage: program input_config_file [--resume] \n mpirun -np 2 program input_config_file";
 
-    if (argc >= 2)
+    /// `--resume` option: continue an interrupted run from the checkpoint data in the existing result folder
+    bool resume = false;
+    auto it = std::find(arguments.begin(), arguments.end(), std::string("--resume"));
+    if (it != arguments.end())
+    {
+        resume = true;
+        arguments.erase(it);
+    }
+
+    if (arguments.size() >= 2)
     { // the first arg is the program name itself, once MPI parameter prepended, then?
         input_file = arguments[1];
     }
@@ -51,6 +60,11 @@ void Context::initialize(int argc, char** argv)
 
     Context::mySingleton = new Context(input_file); // call setup
     Context::mySingleton->myConfigFile = input_file;
+    if (resume)
+    {
+        Context::mySingleton->myConfig["dataStorage"]["resume"] = true;
+        Context::mySingleton->myDataStorage->setResumeMode(true);
+    }
 
     // loguru::init() is optional, to detect -v argument, also setup SIGNAL handler
     int log_argc = 1;
@@ -76,7 +90,9 @@ void Context::finalize()
     // pack result, config, log into zip file, dump, each DataObject has a dump folder
     auto logFile = mySingleton->myDataStorage->getFullPath(mySingleton->myLogFile);
     VLOG_F(LOGLEVEL_PROGRESS, "log file copy %s to %s ", mySingleton->myLogFile.c_str(), logFile.c_str());
-    fs::copy_file(mySingleton->myLogFile, logFile);
+    mySingleton->myDataStorage->flushRecords();
+    // in resume mode, log file of the previous run exists in data storage
+    fs::copy_file(mySingleton->myLogFile, logFile, fs::copy_options::overwrite_existing);
     fs::remove(mySingleton->myLogFile);
 
     std::string savedConfig = mySingleton->myDataStorage->getFullPath("config.json");
@@ -168,7 +184,12 @@ void Context::setupDataStorage(const Config& config)
         VLOG_F(LOGLEVEL_DEBUG, " folder file: %s, working dir: %s", caseName.c_str(),
                storageInfo["workingDir"].get<std::string>().c_str());
     }
+    if (!storageInfo.contains("resume"))
+    {
+        storageInfo["resume"] = false;
+    }
     myDataStorage = std::make_shared<DataStorage>();
+    myDataStorage->setResumeMode(storageInfo["resume"].get<bool>());
     // myDataStorage->setStoragePath(storageInfo["dataStoragePath"]);  // set in pipecontroller::compute()
     myConfig["dataStorage"] = storageInfo;
 }
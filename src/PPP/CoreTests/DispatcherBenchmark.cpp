@@ -0,0 +1,277 @@
+// for visual C++ to support not, and, or keywords
+#include <iso646.h>
+
+#include "PPP/AsynchronousDispatcher.h"
+#include "PPP/ParallelAccessor.h"
+#include "PPP/Processor.h"
+#include "PPP/SparseMatrix.h"
+
+#include "PPP/ProcessorTemplate.h"
+#include "PPP/ThreadPoolExecutor.h"
+
+/**
+ * OCCT-free micro-benchmark of the parallel infrastructure: ThreadPoolExecutor with ParallelAccessor (synchronous)
+ * and AsynchronousDispatcher, driving ProcessorTemplate lambdas with synthetic cost on random coupling graphs.
+ * It tells whether the dispatcher overhead or the geometry operation dominates.
+ *
+ * Usage: `pppDispatcherBenchmark [key=value ...]`, keys are
+ *  items, coupled (average coupled items per item), cost (Constant|HeavyTailed|HubAndSpoke),
+ *  mean (mean cost in microseconds), batch (batch size), threads (max thread count), output (json report file)
+ */
+namespace PPP
+{
+    enum class CostDistribution
+    {
+        Constant,
+        HeavyTailed, ///!< Pareto distribution with the shape 1.5, some pairs are hundreds times of the mean cost
+        HubAndSpoke  ///!< a few hub items are coupled with many items, pairs involving hub item are expensive
+    };
+
+    enum class DispatchMode
+    {
+        Block,       ///!< uncoupled items, `runParallelInBlock()`
+        Synchronous, ///!< coupled item pairs by `ParallelAccessor`
+        Asynchronous ///!< coupled item pairs by `AsynchronousDispatcher`
+    };
+
+    struct BenchmarkSetting
+    {
+        ItemIndexType itemCount = 2000;
+        size_t averageCoupledCount = 10;
+        CostDistribution costDistribution = CostDistribution::Constant;
+        double meanCost = 50e-6; /// seconds
+        ItemIndexType batchSize = 2;
+        unsigned int maxThreadCount = std::thread::hardware_concurrency();
+        std::string outputFile = "dispatcher_benchmark.json";
+
+        /// hub items are the first items, their count is a fraction of all items
+        double hubFraction = 0.01;
+        /// fraction of items coupled with each hub item
+        double hubCouplingFraction = 0.2;
+        double hubCostRatio = 20;
+    };
+
+    /// busy loop rather than sleep, so that the core is really occupied as a geometry operation does
+    void spinFor(const double seconds)
+    {
+        const auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+        while (std::chrono::steady_clock::now() < end)
+        {
+        }
+    }
+
+    /// deterministic uniform random number in (0, 1] from the item pair, so cost needs no storage
+    double pairRandom(const ItemIndexType i, const ItemIndexType j)
+    {
+        uint64_t h = i * 0x9E3779B97F4A7C15ULL ^ (j + 0x632BE59BD9B4E019ULL);
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        return (double(h >> 11) + 1.0) / double(1ULL << 53);
+    }
+
+    double pairCost(const BenchmarkSetting& s, const ItemIndexType i, const ItemIndexType j)
+    {
+        if (s.costDistribution == CostDistribution::HeavyTailed)
+        {
+            const double alpha = 1.5;
+            const double xm = s.meanCost * (alpha - 1) / alpha; // scale to get the mean cost
+            return std::min(xm / std::pow(pairRandom(i, j), 1.0 / alpha), s.meanCost * 1000);
+        }
+        else if (s.costDistribution == CostDistribution::HubAndSpoke)
+        {
+            const ItemIndexType hubCount = ItemIndexType(s.itemCount * s.hubFraction);
+            if (i < hubCount or j < hubCount)
+                return s.meanCost * s.hubCostRatio;
+        }
+        return s.meanCost;
+    }
+
+    AdjacencyMatrixType couplingMatrix(const BenchmarkSetting& s)
+    {
+        auto A = AdjacencyMatrixType::random(s.itemCount, s.averageCoupledCount * s.itemCount);
+        if (s.costDistribution == CostDistribution::HubAndSpoke)
+        {
+            const ItemIndexType hubCount = ItemIndexType(s.itemCount * s.hubFraction);
+            const ItemIndexType stride = ItemIndexType(1.0 / s.hubCouplingFraction);
+            for (ItemIndexType h = 0; h < hubCount; h++)
+            {
+                for (ItemIndexType j = hubCount + h; j < s.itemCount; j += stride)
+                {
+                    if (not A.hasElement(h, j))
+                        A.insertAt(h, j, true);
+                }
+            }
+        }
+        return A;
+    }
+
+    /// run the pipeline once, return the measurement
+    Information runOnce(const BenchmarkSetting& s, const DispatchMode mode, const unsigned int nThreads)
+    {
+        auto A = couplingMatrix(s);
+        auto data = std::make_shared<DataObject>();
+        data->setItemCount(s.itemCount);
+
+        std::atomic<int64_t> busyTime{0}; // nanoseconds, sum of all workers
+        std::atomic<size_t> opCount{0};
+        auto work = [&](const double cost) {
+            const auto start = std::chrono::steady_clock::now();
+            spinFor(cost);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            busyTime += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            opCount++;
+            return true;
+        };
+
+        auto p = std::make_shared<ProcessorTemplate<Processor, bool>>(
+            [&](ItemIndexType i) { return work(pairCost(s, i, i)); }, "myResultData");
+        p->setInputData(data);
+
+        auto threadPool = std::shared_ptr<ThreadPoolType>(new ThreadPoolType());
+        auto te = std::make_shared<ThreadPoolExecutor>(p, nThreads, threadPool);
+        std::shared_ptr<ParallelAccessor> pa;
+        if (mode != DispatchMode::Block)
+        {
+            const size_t dim = 2;
+            if (mode == DispatchMode::Asynchronous)
+                pa = std::make_shared<AsynchronousDispatcher>(s.itemCount, dim, nThreads, s.batchSize);
+            else
+                pa = std::make_shared<ParallelAccessor>(s.itemCount, dim, nThreads, s.batchSize);
+            pa->setCouplingMatrix(A);
+            te->setParallelAccessor(pa);
+
+            Config cfg = {{"indexPattern", IndexPattern::SparseMatrix}, {"coupled", true}};
+            p->setCharactoristics(cfg);
+            p->setCoupledItemProcessor([&](ItemIndexType i, ItemIndexType j) { return work(pairCost(s, i, j)); });
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        te->process();
+        const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+        Information info;
+        info["mode"] = std::string(enum_name(mode));
+        info["threadCount"] = nThreads;
+        info["operationCount"] = size_t(opCount);
+        info["wallTime"] = wall.count();
+        const double busy = double(busyTime) * 1e-9;
+        info["busyTime"] = busy;
+        double dispatch = 0;
+        if (pa)
+        {
+            const auto& st = pa->statistics();
+            dispatch = st.dispatchTime;
+            info["nextCount"] = st.nextCount;
+            info["emptyCount"] = st.emptyCount;
+            info["lockWaitTime"] = st.lockWaitTime;
+            info["dispatchTime"] = st.dispatchTime;
+            info["dispatchLatency"] = st.nextCount ? st.dispatchTime / double(st.nextCount) : 0.0;
+            info["scanCount"] = st.scanCount;
+            info["skippedCount"] = st.skippedCount;
+            info["lockWaitHistogram"] = st.lockWaitHistogram.information();
+            info["remainedCount"] = pa->remainedOperationSize();
+        }
+        // thread time not used in processing or dispatching, e.g. waiting for the barrier or retired worker
+        info["idleTime"] = std::max(wall.count() * nThreads - busy - dispatch, 0.0);
+        return info;
+    }
+
+    std::vector<unsigned int> threadCounts(const unsigned int maxThreadCount)
+    {
+        std::vector<unsigned int> counts;
+        for (unsigned int n = 1; n < maxThreadCount; n *= 2)
+            counts.push_back(n);
+        counts.push_back(std::max(maxThreadCount, 1U));
+        return counts;
+    }
+
+    Information runBenchmark(const BenchmarkSetting& s)
+    {
+        Information report;
+        report["itemCount"] = s.itemCount;
+        report["averageCoupledCount"] = s.averageCoupledCount;
+        report["costDistribution"] = std::string(enum_name(s.costDistribution));
+        report["meanCost"] = s.meanCost;
+        report["batchSize"] = s.batchSize;
+        report["results"] = json::array();
+
+        std::cout << std::setw(14) << "mode" << std::setw(8) << "threads" << std::setw(12) << "wall(s)"
+                  << std::setw(10) << "speedup" << std::setw(14) << "latency(us)" << std::setw(14) << "lockWait(s)"
+                  << std::setw(12) << "idle(s)" << std::setw(10) << "empty" << std::endl;
+        runOnce(s, DispatchMode::Block, 1); // warm up, the first run includes thread pool and memory initialization
+        for (const auto mode : {DispatchMode::Block, DispatchMode::Synchronous, DispatchMode::Asynchronous})
+        {
+            double singleThreadTime = 0;
+            for (const auto nThreads : threadCounts(s.maxThreadCount))
+            {
+                auto info = runOnce(s, mode, nThreads);
+                const double wall = info["wallTime"];
+                if (nThreads == 1)
+                    singleThreadTime = wall;
+                info["speedup"] = singleThreadTime / wall;
+                std::cout << std::setw(14) << enum_name(mode) << std::setw(8) << nThreads << std::setw(12) << wall
+                          << std::setw(10) << singleThreadTime / wall << std::setw(14)
+                          << info.value("dispatchLatency", 0.0) * 1e6 << std::setw(14)
+                          << info.value("lockWaitTime", 0.0) << std::setw(12) << info["idleTime"].get<double>()
+                          << std::setw(10) << info.value("emptyCount", size_t(0)) << std::endl;
+                report["results"].push_back(info);
+            }
+        }
+        return report;
+    }
+
+} // namespace PPP
+
+int main(int argc, char* argv[])
+{
+    using namespace PPP;
+    BenchmarkSetting s;
+    for (int a = 1; a < argc; a++)
+    {
+        const std::string arg = argv[a];
+        const auto pos = arg.find('=');
+        if (pos == std::string::npos)
+        {
+            std::cout << "Usage: pppDispatcherBenchmark [key=value ...]" << std::endl
+                      << "keys: items, coupled, cost (Constant|HeavyTailed|HubAndSpoke), mean (microseconds), "
+                      << "batch, threads, output" << std::endl;
+            return 1;
+        }
+        const std::string key = arg.substr(0, pos);
+        const std::string value = arg.substr(pos + 1);
+        if (key == "items")
+            s.itemCount = std::stoul(value);
+        else if (key == "coupled")
+            s.averageCoupledCount = std::stoul(value);
+        else if (key == "cost")
+        {
+            auto c = enum_cast<CostDistribution>(value);
+            if (not c.has_value())
+            {
+                std::cerr << "unknown cost distribution: " << value << std::endl;
+                return 1;
+            }
+            s.costDistribution = c.value();
+        }
+        else if (key == "mean")
+            s.meanCost = std::stod(value) * 1e-6;
+        else if (key == "batch")
+            s.batchSize = std::stoul(value);
+        else if (key == "threads")
+            s.maxThreadCount = std::stoul(value);
+        else if (key == "output")
+            s.outputFile = value;
+        else
+        {
+            std::cerr << "unknown key: " << key << std::endl;
+            return 1;
+        }
+    }
+
+    auto report = runBenchmark(s);
+    std::ofstream ofs(s.outputFile);
+    ofs << report.dump(4);
+    std::cout << "benchmark report is written to " << s.outputFile << std::endl;
+    return 0;
+}
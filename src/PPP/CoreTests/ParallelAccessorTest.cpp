@@ -71,6 +71,18 @@ namespace PPP
         }
         te->process();
 
+        if (isCoupled)
+        {
+            const auto& st = te->parallelAccessor()->statistics();
+            const auto& counts = st.batchSizeCounts;
+            if (std::accumulate(counts.cbegin(), counts.cend(), size_t(0)) != st.nextCount or
+                st.scannedCount < st.skippedCount)
+            {
+                throw std::runtime_error(std::string("Failed: dispatcher statistics are not consistent\n"));
+            }
+            std::cout << "dispatcher statistics: " << st.information() << std::endl;
+        }
+
         // get data back and check
         bool result;
         if (isCoupled and asynchronous)
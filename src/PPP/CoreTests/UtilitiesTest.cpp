@@ -7,7 +7,12 @@
 #endif
 
 // usually include the user cpp file directly, not the header
+#include "PPP/DataStorage.h"
+#include "PPP/ItemProfiler.h"
+#include "PPP/MemoryMonitor.h"
 #include "PPP/Parameter.h"
+#include "PPP/ProgressChannel.h"
+#include "PPP/Tracer.h"
 #include "PPP/Utilities.cpp"
 
 using namespace PPP;
@@ -122,4 +127,152 @@ TEST_CASE("ParameterTest", "parameterFromJson")
 
 
 
+TEST_CASE("DataStorageTest", "appendRecordPeriodically")
+{
+    const std::string folder = "test_record_storage";
+    fs::remove_all(folder);
+    fs::create_directory(folder);
+    DataStorage storage(folder);
+    const std::string filename = "records.jsonl";
+    storage.setRecordFlushPolicy(3, 1000.0);
+    storage.appendRecord(filename, {{"pair", {0, 1}}});
+    storage.appendRecord(filename, {{"pair", {0, 2}}});
+    REQUIRE(storage.readRecords(filename).size() == 0); // buffered
+    storage.appendRecord(filename, {{"pair", {1, 2}}});
+    REQUIRE(storage.readRecords(filename).size() == 3);
+    storage.appendRecord(filename, {{"pair", {2, 3}}});
+    storage.flushRecords();
+    auto records = storage.readRecords(filename);
+    REQUIRE(records.size() == 4);
+    REQUIRE(records.back()["pair"][1] == 3);
+    fs::remove_all(folder);
+}
+
+TEST_CASE("ItemProfilerTest", "profileItemCalls")
+{
+    ItemProfiler profiler;
+    const ItemIndexType N = 100;
+    std::vector<std::thread> workers;
+    for (ItemIndexType t = 0; t < 4; t++)
+    {
+        workers.emplace_back([&profiler, t, N]() {
+            for (ItemIndexType i = t; i < N; i += 4)
+            {
+                profiler.profile(
+                    i, ItemProfiler::NoItem,
+                    [i]() { std::this_thread::sleep_for(std::chrono::microseconds(i == 42 ? 50000 : 1)); },
+                    [i]() { return i == 7; });
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    REQUIRE_THROWS(profiler.profile(
+        N, N + 1, []() { throw std::runtime_error("failed"); }, []() { return false; }));
+
+    REQUIRE(profiler.size() == N + 1);
+    auto slowest = profiler.slowest(1);
+    REQUIRE(slowest[0].i == 42);
+
+    auto summary = profiler.summary(3, [](const ItemIndexType i) { return "solid" + std::to_string(i); });
+    REQUIRE(summary["callCount"] == N + 1);
+    REQUIRE(summary["threadCount"] == 5);
+    REQUIRE(summary["reportedCount"] == 1);
+    REQUIRE(summary["failedCount"] == 1);
+    REQUIRE(summary["slowest"][0]["name"] == "solid42");
+}
+
+TEST_CASE("TracerTest", "writeTraceEvents")
+{
+    {
+        TraceSpan span("ignored", "test"); // tracer is disabled
+    }
+    Tracer::start();
+    {
+        TraceSpan span("stage", "test");
+        std::thread worker([]() { TraceSpan pairSpan("pair \"quoted\"", "test", 1, 2); });
+        worker.join();
+    }
+    Tracer::stop();
+    const std::string filename = (fs::temp_directory_path() / "ppp_test_trace.json").string();
+    Tracer::write(filename);
+
+    std::ifstream ifs(filename);
+    json trace = json::parse(ifs);
+    ifs.close();
+    fs::remove(filename);
+    size_t threadNames = 0, spans = 0;
+    for (const auto& e : trace["traceEvents"])
+    {
+        if (e["ph"] == "M")
+            threadNames++;
+        else
+        {
+            spans++;
+            REQUIRE(e["name"] != "ignored");
+            if (e["name"] == "pair \"quoted\"")
+                REQUIRE(e["args"]["j"] == 2);
+        }
+    }
+    REQUIRE(threadNames == 2);
+    REQUIRE(spans == 2);
+}
+
+TEST_CASE("ProgressChannelTest", "writeProgressLines")
+{
+    const std::string filename = (fs::temp_directory_path() / "ppp_test_progress.jsonl").string();
+    fs::remove(filename); // progress file is opened in append mode
+    ProgressChannel::open(filename, 0.01);
+    ProgressChannel::startStage("stage", 100, 10); // e.g. item pairs, 10 of them restored from checkpoint
+    {
+        ActiveWorker worker;
+        for (size_t done = 20; done <= 100; done += 10)
+        {
+            ProgressChannel::update(done);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+    ProgressChannel::finishStage();
+    ProgressChannel::close();
+    ProgressChannel::update(0); // ignored after closed
+
+    std::ifstream ifs(filename);
+    std::vector<json> lines;
+    std::string line;
+    while (std::getline(ifs, line))
+        lines.push_back(json::parse(line));
+    ifs.close();
+    fs::remove(filename);
+    REQUIRE(lines.size() >= 3); // start, progress by heartbeat and finish
+    REQUIRE(lines.front()["event"] == "start");
+    REQUIRE(lines.front()["done"] == 10);
+    REQUIRE(lines.front()["total"] == 100);
+    REQUIRE(lines.back()["event"] == "finish");
+    REQUIRE(lines.back()["done"] == 100);
+    REQUIRE(lines.back()["total"] == 100);
+    REQUIRE(lines.back()["activeWorkers"] == 0);
+    // the heartbeat may not be in time to write the last progress, but rate is known after the first progress
+    bool hasProgress = std::any_of(lines.cbegin(), lines.cend(), [](const json& l) {
+        return l["event"] == "progress" and l["activeWorkers"] == 1 and l["rate"].get<double>() > 0;
+    });
+    REQUIRE(hasProgress);
+}
+
+TEST_CASE("MemoryMonitorTest", "samplePeakRSS")
+{
+    MemoryMonitor::addProbe("testProbe", []() { return 1.0; });
+    MemoryMonitor monitor;
+    monitor.start(0.01);
+    {
+        std::vector<char> buffer(64 * 1024 * 1024, 1); // touched, so it is resident
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    }
+    auto info = monitor.stop();
+    REQUIRE(info["testProbe"] == 1.0);
+#if defined(__linux__)
+    REQUIRE(info["peakRSS"].get<double>() >= info["startRSS"].get<double>() + 60);
+#endif
+    REQUIRE(monitor.stop().is_null()); // already stopped
+}
+
 #endif
\ No newline at end of file
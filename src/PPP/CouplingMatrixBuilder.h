@@ -76,11 +76,10 @@ namespace PPP
          */
         virtual void processItem(const std::size_t index) override final
         {
-            const std::size_t NItems = myInputData->itemCount();
-            /// upper triangle for the matrix, also skip the pair (i, i)
-            for (std::size_t j = index + 1; j < NItems; j++)
+            /// upper triangle for the matrix, also skip the pair (i, i), target processor may test pairs in a batch
+            for (const auto j : myTargetProcessor->coupledItems(index))
             {
-                processItemPair(index, j);
+                myCouplingMatrix[index].push_back(std::make_pair(j, true));
             }
         }
 
@@ -23,20 +23,33 @@ namespace PPP
     /**
      * Base class for DataStorage, implementing local file system storage into a folder.
      * providing name conflicting detection, etc.
-     * locking is not necessary since writing only in the main thread
+     * locking is not necessary since writing only in the main thread,
+     * except the append-only record log for checkpoint, which is written by worker threads
      * */
     class AppExport DataStorage
     {
     public:
         DataStorage() = default;
 
-        /// if existed, remove_all content there
+        /// attach to an existing storage folder without cleaning it, e.g. for a writer running in background
+        DataStorage(const std::string& storagePath, bool resume = false)
+                : myStoragePath(storagePath)
+                , myResumeMode(resume)
+        {
+        }
+
+        /// if existed, remove_all content there, unless in resume mode
         virtual void setStoragePath(const std::string pathname)
         {
             fs::path _path{pathname};
+            flushRecords(); // record streams opened in the previous storage path must be closed
 
             /// TODO: generate a unique name, and backup the existing result folder
-            if (fs::exists(_path))
+            if (fs::exists(_path) && myResumeMode)
+            {
+                LOG_F(INFO, "resume mode: keep the existing result storage folder and its checkpoint data");
+            }
+            else if (fs::exists(_path))
             {
                 LOG_F(WARNING, "result storage path exists, remove that folder");
                 fs::remove_all(_path);
@@ -96,9 +109,124 @@ namespace PPP
             return true;
         }
 
+        /// @{ checkpoint and resume
+        /// in resume mode, the existing storage folder and checkpoint records are kept and reused
+        void setResumeMode(bool resume)
+        {
+            myResumeMode = resume;
+        }
+
+        bool resumeMode() const
+        {
+            return myResumeMode;
+        }
+
+        /**
+         * records are buffered and written out periodically, when `count` records are buffered
+         * or `seconds` have elapsed since the last write, whichever comes first;
+         * the records buffered since the last write are lost if the process crashes
+         */
+        void setRecordFlushPolicy(const size_t count, const double seconds)
+        {
+            std::lock_guard<std::mutex> lock(myRecordMutex);
+            myRecordFlushCount = count;
+            myRecordFlushInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(seconds));
+        }
+
+        /**
+         * append a record as one line of json text (json lines format) to a log file in the storage,
+         * completed work survives a crash or Ctrl-C, except records buffered since the last periodic write.
+         * this method is thread-safe, it is designed to be called by worker threads
+         */
+        virtual void appendRecord(const std::string& filename, const json& record)
+        {
+            const std::string line = record.dump() + "\n"; // serialization is done before locking
+            std::lock_guard<std::mutex> lock(myRecordMutex);
+            auto it = myRecordLogs.find(filename);
+            if (it == myRecordLogs.end())
+            {
+                RecordLog log;
+                log.stream = std::make_shared<std::ofstream>(getFullPath(filename), std::ios::out | std::ios::app);
+                log.lastWrite = std::chrono::steady_clock::now();
+                it = myRecordLogs.emplace(filename, std::move(log)).first;
+            }
+            auto& log = it->second;
+            log.buffer += line;
+            log.count++;
+            const auto now = std::chrono::steady_clock::now();
+            if (log.count >= myRecordFlushCount or now - log.lastWrite >= myRecordFlushInterval)
+            {
+                writeRecordLog(log);
+                log.lastWrite = now;
+            }
+        }
+
+        /**
+         * read back all records appended by `appendRecord()`,
+         * a truncated last line (process killed during writing) is skipped with a warning
+         */
+        virtual std::vector<json> readRecords(const std::string& filename)
+        {
+            std::vector<json> records;
+            auto f = getFullPath(filename);
+            if (not fs::exists(f))
+                return records;
+            std::ifstream ifs(f);
+            std::string line;
+            while (std::getline(ifs, line))
+            {
+                if (line.empty())
+                    continue;
+                try
+                {
+                    records.push_back(json::parse(line));
+                }
+                catch (const std::exception&)
+                {
+                    LOG_F(WARNING, "skip an incomplete record in checkpoint file `%s`", filename.c_str());
+                }
+            }
+            return records;
+        }
+
+        /// write buffered records and close all record streams, called at the end of processing or in signal handler
+        void flushRecords()
+        {
+            std::lock_guard<std::mutex> lock(myRecordMutex);
+            for (auto& it : myRecordLogs)
+                writeRecordLog(it.second);
+            myRecordLogs.clear();
+        }
+        /// @}
+
     private:
         /// HDF5 file path or Folder path, even URI as the std::string type
         std::string myStoragePath;
         DataStorageType myStorageType = DataStorageType::Folder;
+        bool myResumeMode = false;
+
+        struct RecordLog
+        {
+            std::shared_ptr<std::ofstream> stream;
+            std::string buffer;
+            size_t count = 0;
+            std::chrono::steady_clock::time_point lastWrite;
+        };
+        std::mutex myRecordMutex;
+        std::unordered_map<std::string, RecordLog> myRecordLogs;
+        size_t myRecordFlushCount = 1000;
+        std::chrono::steady_clock::duration myRecordFlushInterval = std::chrono::seconds(10);
+
+        /// must be called with `myRecordMutex` locked
+        static void writeRecordLog(RecordLog& log)
+        {
+            if (log.count == 0)
+                return;
+            (*log.stream) << log.buffer;
+            log.stream->flush();
+            log.buffer.clear();
+            log.count = 0;
+        }
     };
 } // namespace PPP
\ No newline at end of file
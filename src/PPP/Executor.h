@@ -1,6 +1,9 @@
 #pragma once
 
+#include "ItemProfiler.h"
 #include "Processor.h"
+#include "ProgressChannel.h"
+#include "Tracer.h"
 
 namespace PPP
 {
@@ -22,6 +25,11 @@ namespace PPP
         unsigned int myWorkerCount;
         bool isSynchronous;
 
+        /// record time of each processing call if not nullptr
+        std::shared_ptr<ItemProfiler> myProfiler;
+        /// stage name in the progress channel, empty if this stage is not reported
+        std::string myProgressStage;
+
     public:
         Executor(std::shared_ptr<Processor> gp, unsigned int workerCount = 1)
                 : myProcessor(gp)
@@ -46,6 +54,72 @@ namespace PPP
         {
             return isSynchronous;
         }
+
+        void setProfiler(std::shared_ptr<ItemProfiler> profiler)
+        {
+            myProfiler = profiler;
+        }
+
+        /// the stage is started by `process()` once the unit of work (item or item pair) is known
+        void setProgressStage(const std::string& stage)
+        {
+            myProgressStage = stage;
+        }
+
+        /** set by the Ctrl-C signal handler, which may only do a lock-free atomic store,
+         * then items not yet started are skipped and `prepareOutput()` is not called,
+         * so the caller can checkpoint in the main thread once all workers have returned
+         */
+        static std::atomic<bool>& interruptRequested()
+        {
+            static std::atomic<bool> flag{false};
+            return flag;
+        }
+
+    protected:
+        /// write the "start" line of the progress channel, called once by `process()` before dispatching
+        void startProgress(const size_t total, const size_t done = 0)
+        {
+            if (myProgressStage.size())
+                ProgressChannel::startStage(myProgressStage, total, done);
+        }
+
+        /// call `processItem()` of the processor, profiled if profiler is set, traced if tracer is enabled
+        inline void runItem(const ItemIndexType i)
+        {
+            if (interruptRequested().load(std::memory_order_relaxed))
+                return;
+            TraceSpan span("processItem", "item", i);
+            if (myProfiler)
+            {
+                // the item may already have a report from previous calls, only a grown report counts
+                const std::size_t reportSize = myProcessor->itemReportSize(i);
+                myProfiler->profile(
+                    i, ItemProfiler::NoItem, [&]() { myProcessor->processItem(i); },
+                    [&]() { return myProcessor->itemReportSize(i) != reportSize; });
+            }
+            else
+                myProcessor->processItem(i);
+        }
+
+        /// call `processItemPair()` of the processor, profiled if profiler is set, traced if tracer is enabled
+        inline void runItemPair(const ItemIndexType i, const ItemIndexType j)
+        {
+            if (interruptRequested().load(std::memory_order_relaxed))
+                return;
+            TraceSpan span("processItemPair", "item", i, j);
+            if (myProfiler)
+            {
+                const std::size_t reportSizes[2] = {myProcessor->itemReportSize(i), myProcessor->itemReportSize(j)};
+                myProfiler->profile(i, j, [&]() { myProcessor->processItemPair(i, j); },
+                                    [&]() {
+                                        return myProcessor->itemReportSize(i) != reportSizes[0] or
+                                               myProcessor->itemReportSize(j) != reportSizes[1];
+                                    });
+            }
+            else
+                myProcessor->processItemPair(i, j);
+        }
     };
 
     /// Executor implement serial(single thread) execution
@@ -58,6 +132,7 @@ namespace PPP
 
         virtual void process() override
         {
+            ActiveWorker worker; // the main thread is the only worker
             myProcessor->prepareInput();
 
             const size_t NItems = myProcessor->inputData()->itemCount();
@@ -65,6 +140,7 @@ namespace PPP
             {
                 LOG_F(ERROR, "no items are loaded for processing, check reading setup");
             }
+            startProgress(NItems);
 
             auto ip = myProcessor->attribute<IndexPattern>("indexPattern");
             auto dim = myProcessor->attribute<size_t>("indexDimension");
@@ -78,11 +154,12 @@ namespace PPP
                 {
                     if (myReporter)
                         myReporter(i); // todo: replaced  by operator proxy
-                    myProcessor->processItem(i);
+                    runItem(i);
                 }
             }
 
-            myProcessor->prepareOutput();
+            if (not interruptRequested())
+                myProcessor->prepareOutput();
         }
     };
 
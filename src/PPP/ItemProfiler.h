@@ -0,0 +1,217 @@
+#pragma once
+
+#include "PreCompiled.h"
+#include "TypeDefs.h"
+
+namespace PPP
+{
+    /// outcome of a single `processItem()` or `processItemPair()` call
+    enum class ItemOutcome : uint8_t
+    {
+        Processed, ///!< completed without item report
+        Reported,  ///!< completed, the processor has written item report (warning or error message)
+        Failed     ///!< exception thrown out of the processing call
+    };
+
+    /// \ingroup PPP
+    /**
+     * \brief per-call timing table of `processItem()` and `processItemPair()`, recorded by executor
+     *
+     * Each record is the item (pair) index, start time, duration, worker thread and outcome, 32 bytes.
+     * Records are appended into the table of the calling thread without lock, only the first call
+     * of a thread in this profiler takes a mutex to create its table,
+     * so the overhead is two clock reads and one `push_back()` per call.
+     *
+     * Tables are merged and written as CSV after all workers complete, together with a summary of
+     * the slowest items and pairs.
+     */
+    class AppExport ItemProfiler
+    {
+    public:
+        /// item index of the single item record, for the second item of pair
+        static constexpr ItemIndexType NoItem = std::numeric_limits<ItemIndexType>::max();
+
+        struct Record
+        {
+            ItemIndexType i;
+            ItemIndexType j;   /// `NoItem` for `processItem()`
+            double start;      /// seconds since profiler creation
+            float duration;    /// seconds
+            uint16_t thread;   /// worker sequence in this profiler, starting from zero
+            ItemOutcome outcome;
+        };
+
+    private:
+        typedef std::chrono::steady_clock ClockType;
+        const ClockType::time_point myStartTime;
+        /// unique among all profiler instances, a new profiler may be allocated at the address of a deleted one
+        const uint64_t myId;
+
+        std::mutex myMutex;
+        /// one table per worker thread, unique_ptr keeps table address stable while new tables are added
+        std::vector<std::unique_ptr<std::vector<Record>>> myTables;
+        std::unordered_map<std::thread::id, size_t> myThreadTables;
+
+    public:
+        ItemProfiler()
+                : myStartTime(ClockType::now())
+                , myId(nextId())
+        {
+        }
+
+        ItemProfiler(const ItemProfiler&) = delete;
+
+        /**
+         * run the processing function and record its time and outcome, exception is rethrown after recorded
+         * @param f   processing call `void f()`
+         * @param reported  `bool reported()` to check whether the processor has written item report
+         */
+        template <typename F, typename R>
+        void profile(const ItemIndexType i, const ItemIndexType j, F&& f, R&& reported)
+        {
+            const auto start = ClockType::now();
+            try
+            {
+                f();
+            }
+            catch (...)
+            {
+                record(i, j, start, ItemOutcome::Failed);
+                throw;
+            }
+            record(i, j, start, reported() ? ItemOutcome::Reported : ItemOutcome::Processed);
+        }
+
+        /// total record count, should be called after all workers have completed
+        size_t size() const
+        {
+            size_t n = 0;
+            for (const auto& t : myTables)
+                n += t->size();
+            return n;
+        }
+
+        /// merged records sorted by start time, should be called after all workers have completed
+        std::vector<Record> records() const
+        {
+            std::vector<Record> all;
+            all.reserve(size());
+            for (const auto& t : myTables)
+                all.insert(all.end(), t->cbegin(), t->cend());
+            std::sort(all.begin(), all.end(), [](const Record& a, const Record& b) { return a.start < b.start; });
+            return all;
+        }
+
+        /// the n slowest records, in descending order of duration
+        std::vector<Record> slowest(const size_t n) const
+        {
+            auto all = records();
+            const size_t count = std::min(n, all.size());
+            std::partial_sort(all.begin(), all.begin() + count, all.end(),
+                              [](const Record& a, const Record& b) { return a.duration > b.duration; });
+            all.resize(count);
+            return all;
+        }
+
+        /// write all records into a CSV file, one call per line
+        void writeCSV(const std::string& filename) const
+        {
+            std::ofstream ofs(filename);
+            ofs << "item,pairedItem,thread,start,duration,outcome\n";
+            for (const auto& r : records())
+            {
+                ofs << r.i << ",";
+                if (r.j != NoItem)
+                    ofs << r.j;
+                ofs << "," << r.thread << "," << r.start << "," << r.duration << "," << enum_name(r.outcome) << "\n";
+            }
+        }
+
+        /**
+         * summary of all records and the n slowest records
+         * @param itemName  `std::string itemName(i)` to name the item in summary
+         */
+        template <typename N> Information summary(const size_t n, N&& itemName) const
+        {
+            Information info;
+            double total = 0;
+            size_t failed = 0, reported = 0;
+            for (const auto& t : myTables)
+            {
+                for (const auto& r : *t)
+                {
+                    total += r.duration;
+                    failed += r.outcome == ItemOutcome::Failed;
+                    reported += r.outcome == ItemOutcome::Reported;
+                }
+            }
+            info["callCount"] = size();
+            info["threadCount"] = myTables.size();
+            info["totalTime"] = total;
+            info["reportedCount"] = reported;
+            info["failedCount"] = failed;
+            info["slowest"] = json::array();
+            for (const auto& r : slowest(n))
+            {
+                Information s = {{"item", r.i},
+                                 {"name", itemName(r.i)},
+                                 {"duration", r.duration},
+                                 {"thread", r.thread},
+                                 {"outcome", std::string(enum_name(r.outcome))}};
+                if (r.j != NoItem)
+                {
+                    s["pairedItem"] = r.j;
+                    s["pairedName"] = itemName(r.j);
+                }
+                info["slowest"].push_back(s);
+            }
+            return info;
+        }
+
+    private:
+        void record(const ItemIndexType i, const ItemIndexType j, const ClockType::time_point& start,
+                    const ItemOutcome outcome)
+        {
+            const auto end = ClockType::now();
+            const std::chrono::duration<double> startTime = start - myStartTime;
+            const std::chrono::duration<float> duration = end - start;
+            size_t thread;
+            auto& table = threadTable(thread);
+            table.push_back({i, j, startTime.count(), duration.count(), static_cast<uint16_t>(thread), outcome});
+        }
+
+        static uint64_t nextId()
+        {
+            static std::atomic<uint64_t> counter{0};
+            return ++counter;
+        }
+
+        /// the table of the calling thread, created at the first call of the thread in this profiler
+        std::vector<Record>& threadTable(size_t& thread)
+        {
+            // cache of the last used profiler of this thread, to avoid map lookup under lock
+            thread_local uint64_t cachedId = 0;
+            thread_local std::vector<Record>* cachedTable = nullptr;
+            thread_local size_t cachedThread = 0;
+            if (cachedId == myId)
+            {
+                thread = cachedThread;
+                return *cachedTable;
+            }
+
+            std::lock_guard<std::mutex> lock(myMutex);
+            const auto id = std::this_thread::get_id();
+            auto it = myThreadTables.find(id);
+            if (it == myThreadTables.end())
+            {
+                it = myThreadTables.emplace(id, myTables.size()).first;
+                myTables.push_back(std::make_unique<std::vector<Record>>());
+            }
+            cachedId = myId;
+            cachedThread = it->second;
+            cachedTable = myTables[it->second].get();
+            thread = cachedThread;
+            return *cachedTable;
+        }
+    };
+} // namespace PPP
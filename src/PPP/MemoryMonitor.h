@@ -0,0 +1,215 @@
+#pragma once
+
+#include "PreCompiled.h"
+#include "TypeDefs.h"
+
+#include <condition_variable>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX // otherwise min() and max() macros break std::max
+#endif
+#include <windows.h>
+// windows.h must be included before psapi.h
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace PPP
+{
+
+    /// \ingroup PPP
+    /**
+     * \brief memory high-water sampling of a pipeline stage, all values in MB
+     *
+     * A background thread samples resident set size (RSS) and heap in-use bytes at a fixed interval,
+     * on Linux the kernel peak `VmHWM` is also reset at stage start, so the peak between two samples is not missed.
+     * Modules can register extra probes, e.g. the Geom module adds OCCT `OSD_MemInfo` heap usage.
+     *
+     * Heap in-use is available with glibc only, allocation count is not tracked without an allocator hook.
+     */
+    class AppExport MemoryMonitor
+    {
+    public:
+        typedef std::function<double()> ProbeType;
+
+    private:
+        std::thread mySampler;
+        std::mutex myMutex;
+        std::condition_variable myStopped;
+        bool myRunning = false;
+
+        double myStartRSS = 0;
+        double myPeakRSS = 0;
+        double myStartHeap = 0;
+        double myPeakHeap = 0;
+        bool myPeakReset = false;
+
+    public:
+        MemoryMonitor() = default;
+        MemoryMonitor(const MemoryMonitor&) = delete;
+        ~MemoryMonitor()
+        {
+            stop();
+        }
+
+        /**
+         * start sampling in background thread
+         * @param interval  seconds, zero or negative to sample at start and stop only
+         * @param resetPeak  reset kernel peak RSS, should be false if other stages run concurrently
+         */
+        void start(const double interval = 0.1, const bool resetPeak = true)
+        {
+            myPeakReset = resetPeak and resetPeakRSS();
+            myStartRSS = currentRSS();
+            myPeakRSS = myStartRSS;
+            myStartHeap = heapInUse();
+            myPeakHeap = myStartHeap;
+            myRunning = true;
+            if (interval > 0)
+                mySampler = std::thread([this, interval]() {
+                    const auto period = std::chrono::duration<double>(interval);
+                    std::unique_lock<std::mutex> lock(myMutex);
+                    while (myRunning)
+                    {
+                        myStopped.wait_for(lock, period);
+                        sample();
+                    }
+                });
+        }
+
+        /// stop sampling, return the summary of this stage
+        Information stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(myMutex);
+                if (not myRunning)
+                    return Information();
+                myRunning = false;
+            }
+            myStopped.notify_all();
+            if (mySampler.joinable())
+                mySampler.join();
+            sample();
+
+            Information info;
+            info["startRSS"] = myStartRSS;
+            info["endRSS"] = currentRSS();
+            // kernel high-water mark since reset is exact, otherwise sampled peak or the process lifetime peak
+            if (myPeakReset)
+                info["peakRSS"] = std::max(myPeakRSS, processPeakRSS());
+            else
+                info["peakRSS"] = myPeakRSS > 0 ? myPeakRSS : processPeakRSS();
+            info["peakRSSExact"] = myPeakReset;
+            if (myStartHeap >= 0)
+            {
+                info["startHeap"] = myStartHeap;
+                info["endHeap"] = heapInUse();
+                info["peakHeap"] = myPeakHeap;
+            }
+            for (const auto& p : probes())
+                info[p.first] = p.second();
+            return info;
+        }
+
+        /// register a named probe returning memory in MB, evaluated at stage end, call it in main thread at startup
+        static void addProbe(const std::string& name, ProbeType probe)
+        {
+            probes()[name] = std::move(probe);
+        }
+
+        /// current resident set size in MB, zero if not supported
+        static double currentRSS()
+        {
+#if defined(_WIN32)
+            PROCESS_MEMORY_COUNTERS pmc;
+            if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+                return pmc.WorkingSetSize / MB;
+            return 0;
+#elif defined(__linux__)
+            return statusValue("VmRSS:");
+#else
+            return 0;
+#endif
+        }
+
+        /// peak resident set size of this process in MB, since start or the last `resetPeakRSS()`
+        static double processPeakRSS()
+        {
+#if defined(_WIN32)
+            PROCESS_MEMORY_COUNTERS pmc;
+            if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+                return pmc.PeakWorkingSetSize / MB;
+            return 0;
+#elif defined(__linux__)
+            return statusValue("VmHWM:");
+#else
+            struct rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            return usage.ru_maxrss / MB; // in bytes on macOS
+#endif
+        }
+
+        /// reset the kernel peak RSS counter, Linux 4.0+ only, return false if not supported
+        static bool resetPeakRSS()
+        {
+#if defined(__linux__)
+            std::ofstream ofs("/proc/self/clear_refs");
+            ofs << "5";
+            ofs.flush();
+            return ofs.good();
+#else
+            return false;
+#endif
+        }
+
+        /// heap bytes allocated and not yet freed in MB, negative if not supported
+        static double heapInUse()
+        {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+            const auto mi = mallinfo2();
+            return (mi.uordblks + mi.hblkhd) / MB;
+#else
+            return -1;
+#endif
+        }
+
+    private:
+        static constexpr double MB = 1024.0 * 1024.0;
+
+        static std::map<std::string, ProbeType>& probes()
+        {
+            static std::map<std::string, ProbeType> p;
+            return p;
+        }
+
+        /// must be called with `myMutex` locked or after the sampler thread joined
+        void sample()
+        {
+            myPeakRSS = std::max(myPeakRSS, currentRSS());
+            myPeakHeap = std::max(myPeakHeap, heapInUse());
+        }
+
+#if defined(__linux__)
+        /// value in kB of a field in `/proc/self/status`, converted into MB
+        static double statusValue(const std::string& field)
+        {
+            std::ifstream ifs("/proc/self/status");
+            std::string line;
+            while (std::getline(ifs, line))
+            {
+                if (line.compare(0, field.size(), field) == 0)
+                    return std::stod(line.substr(field.size())) / 1024.0;
+            }
+            return 0;
+        }
+#endif
+    };
+
+} // namespace PPP
@@ -3,6 +3,7 @@
 #include "PreCompiled.h"
 #include "Progressor.h"
 #include "SparseMatrix.h"
+#include "Tracer.h"
 #include "TypeDefs.h"
 
 
@@ -44,6 +45,33 @@ namespace PPP
         // virtual std::vector<IndexerType> next() = 0;
     };
 
+    /// histogram of non-negative integer values, the bucket k > 0 counts values in [2^(k-1), 2^k), bucket 0 counts zero
+    struct Log2Histogram
+    {
+        static const size_t BucketCount = 32;
+        std::array<size_t, BucketCount> counts = {};
+
+        void add(const size_t value)
+        {
+            size_t k = 0;
+            for (size_t v = value; v > 0 && k < BucketCount - 1; v >>= 1)
+                k++;
+            counts[k]++;
+        }
+
+        /// nonempty buckets as an array of `{"upTo": exclusive upper bound, "count": n}`
+        Information information() const
+        {
+            Information info = json::array();
+            for (size_t k = 0; k < BucketCount; k++)
+            {
+                if (counts[k])
+                    info.push_back({{"upTo", size_t(1) << k}, {"count", counts[k]}});
+            }
+            return info;
+        }
+    };
+
     /**
      * ParallelAccessor implement a lock free parallel operation (write/modification),
      * on a multi-dimensional data structure, e.g. sparse matrix, when items are coupled together.
@@ -67,6 +95,42 @@ namespace PPP
         typedef std::vector<ItemIndexType> indexer;
         typedef std::vector<indexer> indexers;
 
+        /// statistics of `next()` calls and `myRemainedItems` scans, updated within the `myMutex` lock
+        struct DispatchStatistics
+        {
+            size_t nextCount = 0;
+            /// next() returned no indexer while some items are still remained, i.e. blocked by locked items
+            size_t emptyCount = 0;
+            double lockWaitTime = 0; /// seconds waiting to acquire `myMutex`, sum of all calls
+            double dispatchTime = 0; /// seconds spent in `next()`, lock wait included, sum of all calls
+
+            /// scans of `myRemainedItems` to pick up unlocked indexers, by `next()` or `produce()`
+            size_t scanCount = 0;
+            size_t scannedCount = 0; /// indexers visited by all scans
+            size_t skippedCount = 0; /// visited indexers skipped because an item is locked by other worker
+
+            Log2Histogram lockWaitHistogram; /// in microseconds
+            Log2Histogram scanHistogram;     /// visited indexers per scan
+            std::vector<size_t> batchSizeCounts; /// `next()` call count of each returned batch size
+
+            Information information() const
+            {
+                Information info;
+                info["nextCount"] = nextCount;
+                info["emptyCount"] = emptyCount;
+                info["lockWaitTime"] = lockWaitTime;
+                info["dispatchTime"] = dispatchTime;
+                info["dispatchLatency"] = nextCount ? dispatchTime / double(nextCount) : 0.0;
+                info["scanCount"] = scanCount;
+                info["scannedCount"] = scannedCount;
+                info["skippedCount"] = skippedCount;
+                info["lockWaitHistogram"] = lockWaitHistogram.information();
+                info["scanHistogram"] = scanHistogram.information();
+                info["batchSizeCounts"] = batchSizeCounts;
+                return info;
+            }
+        };
+
     private:
         ParallelAccessor(const ParallelAccessor&) = delete;
 
@@ -87,12 +151,16 @@ namespace PPP
         const bool isExclusive = true; // must be true for coupled data
 
         std::unordered_set<indexer> myRemainedItems;
+        /// all operations of the coupling matrix, including those removed as completed in a previous run
+        size_t myOperationSize = 0;
         /// for synchronous mode only, the schedular wait for all workers completed then schedule next batch
         std::vector<indexers> myPreviouslyLocked;
 
         std::mutex myMutex;
         std::unordered_set<ItemIndexType> myLockedItems;
 
+        DispatchStatistics myStatistics;
+
     public:
         ParallelAccessor(const ItemIndexType itemCount, const size_t dim, const ItemIndexType nWorker,
                          const ItemIndexType batchSize = 3)
@@ -108,6 +176,7 @@ namespace PPP
                 std::cout << "dimesion greater than 2 is not implemented";
             }
             myLockedItems.reserve(myWorkerCount * myBatchSize * dim);
+            myStatistics.batchSizeCounts.resize(myBatchSize + 1, 0);
         }
 
         virtual ~ParallelAccessor()
@@ -132,7 +201,25 @@ namespace PPP
                 }
             }
             /// consider: this method should moved to start(), but user may forget to call start()
-            myProgressor = std::make_shared<Progressor>(remainedOperationSize());
+            myOperationSize = remainedOperationSize();
+            myProgressor = std::make_shared<Progressor>(myOperationSize);
+        }
+
+        /**
+         * remove indexers which have been completed in a previous run, loaded from checkpoint,
+         * must be called in the main thread after `setCouplingMatrix()` and before dispatching.
+         * @return the number of indexers removed from `myRemainedItems`
+         */
+        size_t removeCompletedItems(const indexers& completed)
+        {
+            size_t count = 0;
+            for (const auto& ind : completed)
+            {
+                count += myRemainedItems.erase(ind);
+            }
+            if (myProgressor)
+                myProgressor->remain(remainedOperationSize());
+            return count;
         }
 
         inline size_t remainedOperationSize() const
@@ -140,11 +227,22 @@ namespace PPP
             return myRemainedItems.size();
         }
 
+        inline size_t operationSize() const
+        {
+            return myOperationSize;
+        }
+
         size_t indexDimension() const
         {
             return myIndexDim;
         }
 
+        /// should be read after all workers have completed
+        const DispatchStatistics& statistics() const
+        {
+            return myStatistics;
+        }
+
         /// has barrier to wait all threads to complete, before next
         virtual bool synchronized() const
         {
@@ -157,10 +255,13 @@ namespace PPP
          * */
         virtual const indexers next(const indexers prevLocked = indexers()) override
         {
+            const auto start = std::chrono::steady_clock::now();
             std::lock_guard<std::mutex> grard(myMutex); // exception safer
+            recordLockWait(start);
 
             unlock(prevLocked); // in case forgeting to unlock before run this function
             indexers tmp;
+            size_t skipped = 0;
             auto it = myRemainedItems.cbegin();
             const auto& iend = myRemainedItems.cend();
             for (ItemIndexType i = 0; i < myBatchSize; i++)
@@ -168,6 +269,7 @@ namespace PPP
                 while (it != iend && isLocked(*it)) // test it is not ending first!
                 {
                     it++;
+                    skipped++;
                 }
                 if (it != iend)
                 {
@@ -176,6 +278,8 @@ namespace PPP
                     it++;
                 }
             }
+            recordScan(tmp.size() + skipped, skipped);
+            recordDispatch(start, tmp.size());
             return tmp;
         }
 
@@ -206,6 +310,41 @@ namespace PPP
         }
 
     protected:
+        /// should be called just after `myMutex` is acquired
+        inline void recordLockWait(const std::chrono::steady_clock::time_point& start)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            const std::chrono::duration<double> wait = now - start;
+            myStatistics.lockWaitTime += wait.count();
+            myStatistics.lockWaitHistogram.add(size_t(wait.count() * 1e6));
+            if (Tracer::enabled())
+                Tracer::complete("lockWait", "dispatcher", start, now);
+        }
+
+        /// should be called before `myMutex` is released
+        inline void recordDispatch(const std::chrono::steady_clock::time_point& start, const size_t batchSize)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            const std::chrono::duration<double> elapsed = now - start;
+            myStatistics.dispatchTime += elapsed.count();
+            if (Tracer::enabled())
+                Tracer::complete("next", "dispatcher", start, now);
+            myStatistics.nextCount++;
+            if (batchSize == 0 and myRemainedItems.size() > 0)
+                myStatistics.emptyCount++;
+            if (batchSize < myStatistics.batchSizeCounts.size())
+                myStatistics.batchSizeCounts[batchSize]++;
+        }
+
+        /// a scan of `myRemainedItems`, should be called before `myMutex` is released
+        inline void recordScan(const size_t visited, const size_t skipped)
+        {
+            myStatistics.scanCount++;
+            myStatistics.scannedCount += visited;
+            myStatistics.skippedCount += skipped;
+            myStatistics.scanHistogram.add(visited);
+        }
+
         inline bool isLocked(const indexer& ind)
         {
             for (const auto& i : ind)
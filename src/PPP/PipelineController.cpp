@@ -4,10 +4,16 @@
 #include "ConsoleOperator.h"
 #include "Context.h"
 #include "Logger.h"
+#include "MemoryMonitor.h"
 #include "PreCompiled.h"
+#include "ProgressChannel.h"
+#include "Tracer.h"
 #include "Utilities.h"
 
 #include <csignal>
+#include <deque>
+#include <future>
+#include <numeric>
 
 //#define PPP_USE_THREADING 1
 #include "./Executor.h"
@@ -34,10 +40,11 @@ TYPESYSTEM_SOURCE(PPP::CommandLineProcessor, PPP::Processor);
 #endif
 #endif
 
-std::function<void(int)> callback_wrapper;
+/// only async-signal-safe operations are allowed: a lock-free atomic store, or `_Exit()` if Ctrl-C is pressed again
 static void ppp_signal_callback_handler(int signum)
 {
-    callback_wrapper(signum);
+    if (PPP::Executor::interruptRequested().exchange(true))
+        std::_Exit(signum);
 }
 
 namespace PPP
@@ -185,64 +192,331 @@ namespace PPP
 #endif
     }
 
+    std::shared_ptr<DataObject> PipelineController::readInput(size_t iData, std::shared_ptr<DataStorage> ds)
+    {
+#if PPP_BUILD_TYPE
+        std::shared_ptr<Processor> reader = createProcessor(myConfig["readers"][iData]);
+#else
+        std::shared_ptr<Reader> reader = std::make_shared<Reader>();
+#endif
+        reader->setDataStorage(ds);
+        reader->setConfig(myConfig["readers"][iData]);
+        reader->process();
+        reader->prepareOutput();
+        auto data = reader->outputData();
+        if (!data)
+        {
+            std::cout << "Failed to load the  data from file: \n"
+                      << " Here is the reader config: \n"
+                      << myConfig["readers"][iData][""] << std::endl;
+        }
+        return data;
+    }
+
+    double PipelineController::inputFileSize(size_t iData) const
+    {
+        auto fileName = fs::path(myConfig["readers"][iData]["dataFileName"].get<std::string>());
+        return fs::exists(fileName) ? static_cast<double>(fs::file_size(fileName)) / (1024.0 * 1024.0) : 0.0;
+    }
+
+    void PipelineController::monitorStage(const std::string& stageName, Information& info, bool resetPeak,
+                                          std::function<void()> stage)
+    {
+        const double memoryBudget = myConfig["parallelism"].value("memoryBudget", 0.0);
+        MemoryMonitor memory;
+        memory.start(myConfig["parallelism"].value("memorySamplingInterval", 0.1), resetPeak);
+        stage();
+        auto memoryUsage = memory.stop();
+        const double peakRSS = memoryUsage["peakRSS"];
+        VLOG_F(LOGLEVEL_PROGRESS, "%s peak RSS %.1lf MB, started at %.1lf MB", stageName.c_str(), peakRSS,
+               memoryUsage["startRSS"].get<double>());
+        if (memoryBudget > 0 and peakRSS > memoryBudget)
+            LOG_F(WARNING, "%s exceeded the memory budget %.0lf MB", stageName.c_str(), memoryBudget);
+        info["memoryUsage"][stageName] = memoryUsage;
+    }
+
+    std::shared_ptr<Processor>
+    PipelineController::createWriter(size_t iData, const std::vector<std::shared_ptr<Processor>>& processors,
+                                     std::shared_ptr<DataObject> data, std::shared_ptr<Information> info)
+    {
+        // processed data writing, writer is not always needed
+        std::shared_ptr<Processor> writer;
+        bool hasWriter = !myConfig["writers"].empty();
+        if (hasWriter)
+        {
+#if PPP_BUILD_TYPE
+            writer = createProcessor(myConfig["writers"][iData]);
+#else
+            writer = std::make_shared<Writer>();
+#endif
+            writer->setConfig(myConfig["writers"][iData]);
+            if (processors.size() == 0) // if there is no processor, do data IO format translation
+            {
+                writer->setInputData(data);
+                writer->setInputInformation(info);
+            }
+            else
+            {
+                writer->setInputData(processors[processors.size() - 1]->outputData());
+                writer->setInputInformation(processors[processors.size() - 1]->getOutputInformation());
+            }
+        }
+        return writer;
+    }
+
     void PipelineController::computeAll()
     {
+        /// concurrent mode: several reader->processors->writer chains run at the same time
+        size_t concurrentInputs = 0;
+        if (myConfig["parallelism"].contains("concurrentInputs"))
+            concurrentInputs = myConfig["parallelism"]["concurrentInputs"].get<size_t>();
+        if (concurrentInputs > 1 && myConfig["readers"].size() > 1)
+        {
+            computeConcurrently(concurrentInputs);
+            return;
+        }
+
+        /// pipelined batch mode: writer of input k runs in background, while input k+1 is read and processed,
+        /// at most `maxInFlightDatasets` writers are pending to keep memory bounded, zero for serial mode
+        size_t maxInFlight = 0;
+        if (myConfig["parallelism"].contains("maxInFlightDatasets"))
+            maxInFlight = myConfig["parallelism"]["maxInFlightDatasets"].get<size_t>();
+        std::deque<std::future<void>> pendingWriters;
 
         for (size_t iData = 0; iData < myConfig["readers"].size(); iData++)
         {
+            // the oldest writer must complete before the next dataset is loaded into memory
+            while (maxInFlight > 0 && pendingWriters.size() >= maxInFlight)
+            {
+                waitForTask(pendingWriters.front());
+                pendingWriters.pop_front();
+            }
+
             // set diff result path for each input file
             auto inputName = fs::path(myConfig["readers"][iData]["dataFileName"].get<std::string>());
             std::string storagePath = Context::dataStorage().generateStoragePath(inputName.stem().string());
             Context::dataStorage().setStoragePath(storagePath);
-#if PPP_BUILD_TYPE
-            std::shared_ptr<Processor> reader = createProcessor(myConfig["readers"][iData]);
-#else
-            std::shared_ptr<Reader> reader = std::make_shared<Reader>();
-#endif
-            reader->setConfig(myConfig["readers"][iData]);
-            reader->process();
-            reader->prepareOutput();
-            auto data = reader->outputData();
-            if (!data)
-            {
-                std::cout << "Failed to load the  data from file: \n"
-                          << " Here is the reader config: \n"
-                          << myConfig["readers"][iData][""] << std::endl;
-            }
 
             auto info = std::make_shared<Information>();
             (*info)["parallelism"] = myConfig["parallelism"];
+            std::shared_ptr<DataObject> data;
+            // the peak RSS counter is process-wide, it must not be reset while a writer runs in background
+            monitorStage("reader", *info, pendingWriters.empty(), [&]() { data = readInput(iData); });
+            (*info)["memoryUsage"]["reader"]["inputSize"] = inputFileSize(iData);
 
             compute(data, info);
+            if (Executor::interruptRequested())
+            {
+                LOG_F(WARNING, "processing is interrupted, the pipeline exits without writing output");
+                std::exit(SIGINT);
+            }
 
             // report writing, todo: get output name from configuration
             std::string outfile = Context::dataStorage().getFullPath("processed_info.json");
-            std::fstream report_info(outfile);
+            auto writer = createWriter(iData, myProcessors, data, info);
 
-            // processed data writing, writer is not always needed
-            bool hasWriter = !myConfig["writers"].empty();
-            if (hasWriter)
-            {
-#if PPP_BUILD_TYPE
-                std::shared_ptr<Processor> writer = createProcessor(myConfig["writers"][iData]);
-#else
-                std::shared_ptr<Writer> writer = std::make_shared<Writer>();
-#endif
-                writer->setConfig(myConfig["writers"][iData]);
-                if (myProcessors.size() == 0) // if there is no processor, do data IO format translation
+            auto writeOutput = [this, writer, info, outfile, maxInFlight]() {
+                if (writer)
                 {
-                    writer->setInputData(data);
-                    writer->setInputInformation(info);
+                    monitorStage("writer", *info, maxInFlight == 0, [&writer]() {
+                        writer->prepareInput();
+                        writer->process();
+                    });
                 }
-                else
+                std::fstream report_info(outfile);
+                report_info << (*info);
+            };
+
+            if (maxInFlight > 0)
+            {
+                // global storage path will be changed by the next input, writer must keep a snapshot
+                if (writer)
+                    writer->setDataStorage(std::make_shared<DataStorage>(Context::dataStorage().storagePath()));
+                pendingWriters.push_back(std::async(std::launch::async, writeOutput));
+            }
+            else
+            {
+                writeOutput();
+            }
+        }
+
+        for (auto& f : pendingWriters)
+            waitForTask(f);
+    }
+
+    void PipelineController::computeConcurrently(size_t concurrentInputs)
+    {
+        installSignalHandler();
+        const size_t nCores = myConfig["parallelism"]["threadsOnNode"];
+        const size_t nInputs = myConfig["readers"].size();
+        const size_t nSlots = std::min(concurrentInputs, nInputs);
+        /// the timeline, progress stream and peak RSS reset are process-wide, they can not tell chains apart
+        if (myConfig["parallelism"].value("traceFile", std::string()).size() or
+            myConfig["parallelism"].value("progressFile", std::string()).size())
+            LOG_F(WARNING, "traceFile and progressFile are ignored if input files are processed concurrently");
+
+        /// input file size is used as the estimated work, it is known before reading,
+        /// the largest input is started first, so that a big input does not start last and become the tail
+        std::vector<size_t> order(nInputs);
+        std::vector<double> works(nInputs);
+        for (size_t iData = 0; iData < nInputs; iData++)
+        {
+            works[iData] = std::max(inputFileSize(iData), 1e-6); // MB
+            order[iData] = iData;
+        }
+        std::stable_sort(order.begin(), order.end(), [&works](size_t a, size_t b) { return works[a] > works[b]; });
+
+        // the storage folders are prepared in the main thread, each chain keeps its own DataStorage instance
+        std::vector<std::shared_ptr<DataStorage>> storages(nInputs);
+        for (size_t iData = 0; iData < nInputs; iData++)
+        {
+            auto inputName = fs::path(myConfig["readers"][iData]["dataFileName"].get<std::string>());
+            std::string storagePath = Context::dataStorage().generateStoragePath(inputName.stem().string());
+            Context::dataStorage().setStoragePath(storagePath);
+            storages[iData] = std::make_shared<DataStorage>(Context::dataStorage().storagePath(),
+                                                            Context::dataStorage().resumeMode());
+        }
+
+        /// cores are split between slots in proportion to their estimated work, which is predicted by
+        /// simulating the work queue: the next input goes to the slot of the least accumulated work.
+        /// Each slot has at least one core, spare cores are given by the largest remainder of the weighted share.
+        std::vector<double> slotWorks(nSlots, 0.0);
+        for (size_t k = 0; k < nInputs; k++)
+            *std::min_element(slotWorks.begin(), slotWorks.end()) += works[order[k]];
+        const double totalWork = std::accumulate(slotWorks.cbegin(), slotWorks.cend(), 0.0);
+        const size_t spareCores = nCores > nSlots ? nCores - nSlots : 0;
+        std::vector<size_t> slotCores(nSlots, 1);
+        std::vector<double> remainders(nSlots);
+        size_t givenCores = 0;
+        for (size_t iSlot = 0; iSlot < nSlots; iSlot++)
+        {
+            const double share = spareCores * slotWorks[iSlot] / totalWork;
+            slotCores[iSlot] += static_cast<size_t>(share);
+            givenCores += static_cast<size_t>(share);
+            remainders[iSlot] = share - std::floor(share);
+        }
+        std::vector<size_t> bySlotRemainder(nSlots);
+        std::iota(bySlotRemainder.begin(), bySlotRemainder.end(), 0);
+        std::stable_sort(bySlotRemainder.begin(), bySlotRemainder.end(),
+                         [&remainders](size_t a, size_t b) { return remainders[a] > remainders[b]; });
+        for (size_t r = 0; givenCores < spareCores; r++, givenCores++)
+            slotCores[bySlotRemainder[r]]++;
+
+        /// work queue: each slot takes the next input as soon as its chain completes, no barrier between inputs.
+        /// The first input of each slot is fixed, as in the simulation, so the largest input gets the most cores.
+        /// Each slot runs in its own TBB arena, so the thread count of a chain is enforced, rather than shared
+        std::atomic<size_t> next{nSlots};
+        std::vector<std::future<void>> slots;
+        for (size_t iSlot = 0; iSlot < nSlots; iSlot++)
+        {
+            const size_t cores = slotCores[iSlot];
+            LOG_F(INFO, "slot %lu of estimated work %.3g MB is given %lu threads", iSlot, slotWorks[iSlot], cores);
+            slots.push_back(std::async(std::launch::async, [this, &next, &order, &storages, nInputs, iSlot,
+                                                            slotCores = cores]() {
+#if PPP_HAS_TBB
+                tbb::task_arena arena(static_cast<int>(slotCores));
+#endif
+                for (size_t k = iSlot; k < nInputs and not Executor::interruptRequested(); k = next++)
                 {
-                    writer->setInputData(myProcessors[myProcessors.size() - 1]->outputData());
-                    writer->setInputInformation(myProcessors[myProcessors.size() - 1]->getOutputInformation());
+                    const size_t iData = order[k];
+                    VLOG_F(LOGLEVEL_PROGRESS, "input #%lu is processed concurrently with %lu threads", iData,
+                           slotCores);
+                    auto chain = [this, iData, slotCores, &storages]() {
+                        try
+                        {
+                            computeChain(iData, slotCores, storages[iData]);
+                        }
+                        catch (const std::exception& e)
+                        {
+                            LOG_F(ERROR, "processing of input #%lu failed: %s", iData, e.what());
+                        }
+                    };
+#if PPP_HAS_TBB
+                    arena.execute(chain);
+#else
+                    chain();
+#endif
                 }
+            }));
+        }
+        for (auto& f : slots)
+            waitForTask(f);
+        if (Executor::interruptRequested())
+        {
+            LOG_F(WARNING, "processing is interrupted, the pipeline exits without writing output");
+            std::exit(SIGINT);
+        }
+    }
+
+    void PipelineController::computeChain(size_t iData, size_t nCores, std::shared_ptr<DataStorage> ds)
+    {
+        auto info = std::make_shared<Information>();
+        (*info)["parallelism"] = myConfig["parallelism"];
+        (*info)["parallelism"]["threadsOnNode"] = nCores;
+        std::shared_ptr<DataObject> data;
+        monitorStage("reader", *info, false, [&]() { data = readInput(iData, ds); }); // chains run concurrently
+        (*info)["memoryUsage"]["reader"]["inputSize"] = inputFileSize(iData);
+
+        /// processors keep state of the input data, so each chain must have its own instances
+        std::vector<std::shared_ptr<Processor>> processors;
+#if PPP_BUILD_TYPE
+        for (auto& p : myConfig["processors"])
+        {
+            auto sp = createProcessor(p);
+            if (sp)
+            {
+                sp->setDataStorage(ds);
+                processors.push_back(sp);
+            }
+        }
+#endif
+        computeProcessors(processors, data, info, nCores);
+        if (Executor::interruptRequested())
+            return;
+
+        auto writer = createWriter(iData, processors, data, info);
+        if (writer)
+        {
+            writer->setDataStorage(ds);
+            monitorStage("writer", *info, false, [&writer]() {
                 writer->prepareInput();
                 writer->process();
-            }
-            report_info << (*info);
+            });
+        }
+        std::fstream report_info(ds->getFullPath("processed_info.json"));
+        report_info << (*info);
+    }
+
+    void PipelineController::reportProfile(std::shared_ptr<Processor> processor, const std::string& stageName,
+                                           const ItemProfiler& profiler, Information& info)
+    {
+        std::string name = stageName;
+        std::replace(name.begin(), name.end(), ':', '_'); // class name with namespace is not a valid file name
+        profiler.writeCSV(processor->dataStoragePath(name + "_profile.csv"));
+
+        const size_t topCount = myConfig["parallelism"].value("profileTopCount", size_t(10));
+        auto summary =
+            profiler.summary(topCount, [&processor](const ItemIndexType i) { return processor->itemName(i); });
+        for (const auto& r : summary["slowest"])
+        {
+            std::string itemNames = r["name"];
+            if (r.contains("pairedName"))
+                itemNames += " and " + r["pairedName"].get<std::string>();
+            VLOG_F(LOGLEVEL_PROGRESS, "slow %s call: %s took %lf seconds, %s", stageName.c_str(), itemNames.c_str(),
+                   r["duration"].get<double>(), r["outcome"].get<std::string>().c_str());
+        }
+        info["itemProfiles"][stageName] = summary;
+    }
+
+    void PipelineController::waitForTask(std::future<void>& f)
+    {
+        try
+        {
+            f.get(); // exception thrown in the background thread is rethrown here
+        }
+        catch (const std::exception& e)
+        {
+            LOG_F(ERROR, "background task failed: %s", e.what());
         }
     }
 
@@ -269,20 +543,19 @@ namespace PPP
         this->finalize();
     }
 
-    void PipelineController::handleSignal(int signum)
+    void PipelineController::handleInterrupt(std::shared_ptr<Processor> processor)
     {
-        myCurrentProcessor->dump(); // get the current running processor
-        LOG_F(WARNING, "Caught interrupt signal %d, call clean up function", signum);
-        std::exit(signum); // Terminate program
+        LOG_F(WARNING, "Caught interrupt signal, save checkpoint of the processor %s",
+              processor->className().c_str());
+        processor->checkpoint(); // completed work can be resumed by `--resume` command line option
+        processor->dump();
     }
 
-    void PipelineController::compute(std::shared_ptr<DataObject> data, std::shared_ptr<Information> info)
+    void PipelineController::installSignalHandler()
     {
-
         /// NOTE:the ctrl-C signal handler must be installed to the main thread
         /// it is expected more error message can be capture like data storage dump,
         /// if SIGSEGV (invalid access storage) happened on other threads
-        callback_wrapper = std::bind(&PipelineController::handleSignal, this, std::placeholders::_1);
 #ifndef _WIN32
         struct sigaction sigIntHandler;
         sigIntHandler.sa_handler = ppp_signal_callback_handler;
@@ -290,11 +563,47 @@ namespace PPP
         sigIntHandler.sa_flags = 0;
         sigaction(SIGINT, &sigIntHandler, NULL); // more signal handler can be added for diff signal
 #endif
+    }
 
+    void PipelineController::compute(std::shared_ptr<DataObject> data, std::shared_ptr<Information> info)
+    {
+        installSignalHandler();
         size_t nCores = myConfig["parallelism"]["threadsOnNode"];
+        /// timeline of processors, worker tasks and dispatcher calls, view it in `chrome://tracing` or Perfetto
+        const std::string traceFile = myConfig["parallelism"].value("traceFile", std::string());
+        if (traceFile.size())
+            Tracer::start();
+        /// JSON-lines progress stream for job scheduler, relative path is in the output folder
+        const std::string progressFile = myConfig["parallelism"].value("progressFile", std::string());
+        if (progressFile.size())
+        {
+            const bool isAbsolute = fs::path(progressFile).is_absolute();
+            ProgressChannel::open(isAbsolute ? progressFile : Context::dataStorage().getFullPath(progressFile),
+                                  myConfig["parallelism"].value("progressInterval", 1.0));
+        }
+        computeProcessors(myProcessors, data, info, nCores);
+        if (progressFile.size())
+            ProgressChannel::close();
+        if (traceFile.size())
+        {
+            Tracer::stop();
+            const std::string traceFilePath = Context::dataStorage().getFullPath(traceFile);
+            Tracer::write(traceFilePath);
+            (*info)["traceFile"] = traceFilePath;
+            VLOG_F(LOGLEVEL_PROGRESS, "timeline trace is written to %s", traceFilePath.c_str());
+        }
+    }
+
+    void PipelineController::computeProcessors(std::vector<std::shared_ptr<Processor>>& processors,
+                                               std::shared_ptr<DataObject> data, std::shared_ptr<Information> info,
+                                               size_t nCores)
+    {
         bool serialMode = nCores == 1UL;
+        // only the shared pipeline in the main thread is tracked for signal handling
+        bool trackCurrent = &processors == &myProcessors;
 
         /// NOTE: tbb::task_group does not support std::make_shared<>() on clang
+        /// all task groups share the same TBB worker threads, nCores controls the task count spawned
         std::shared_ptr<ThreadPoolType> threadPool;
         if (not serialMode)
         {
@@ -306,36 +615,94 @@ namespace PPP
         }
 
 
-        for (std::size_t i = 0; i < myProcessors.size(); i++)
+        /// in MB, warn if a stage may exceed it, zero to disable
+        const double memoryBudget = myConfig["parallelism"].value("memoryBudget", 0.0);
+        const double memorySamplingInterval = myConfig["parallelism"].value("memorySamplingInterval", 0.1);
+        /// the largest peak RSS growth of completed stages, to predict the next stage,
+        /// seeded by the reader, as a processor usually grows memory no less than the input size
+        double maxMemoryGrowth = 0;
+        if (info->contains("memoryUsage") and (*info)["memoryUsage"].contains("reader"))
+        {
+            const auto& reader = (*info)["memoryUsage"]["reader"];
+            maxMemoryGrowth = std::max(reader["peakRSS"].get<double>() - reader["startRSS"].get<double>(),
+                                       reader.value("inputSize", 0.0));
+        }
+
+        for (std::size_t i = 0; i < processors.size(); i++)
         {
             std::string pname = myConfig["processors"][i]["className"];
+            /// the same processor class may be used by several stages, stage reports are keyed by index and name
+            const std::string stageName = std::to_string(i) + ":" + pname;
             VLOG_F(LOGLEVEL_PROGRESS, " ========processor #%lu %s started=======", i, pname.c_str());
-            myCurrentProcessor = myProcessors[i]; // current processor index is needed in handleSignal()
             auto start = std::chrono::steady_clock::now();
             json thisConfig = myConfig["processors"][i];
-            myProcessors[i]->setConfig(thisConfig);
+            processors[i]->setConfig(thisConfig);
             if (i == 0)
             {
-                myProcessors[i]->setInputData(data);
-                myProcessors[i]->setInputInformation(info);
+                processors[i]->setInputData(data);
+                processors[i]->setInputInformation(info);
             }
             else
             {
-                myProcessors[i]->setInputData(myProcessors[i - 1]->outputData());
-                myProcessors[i]->setInputInformation(myProcessors[i - 1]->getOutputInformation());
+                processors[i]->setInputData(processors[i - 1]->outputData());
+                processors[i]->setInputInformation(processors[i - 1]->getOutputInformation());
             }
-            myProcessors[i]->setOperator(myOperator);
+            processors[i]->setOperator(myOperator);
 
             std::shared_ptr<Executor> aExecutor;
             if (serialMode)
-                aExecutor = std::make_shared<SequentialExecutor>(myProcessors[i]);
+                aExecutor = std::make_shared<SequentialExecutor>(processors[i]);
             else
-                aExecutor = std::make_shared<ThreadPoolExecutor>(myProcessors[i], nCores, threadPool);
+                aExecutor = std::make_shared<ThreadPoolExecutor>(processors[i], nCores, threadPool);
+            if (trackCurrent)
+                aExecutor->setProgressStage(pname);
+
+            std::shared_ptr<ItemProfiler> profiler;
+            if (myConfig["parallelism"].value("profileItems", false))
+            {
+                profiler = std::make_shared<ItemProfiler>();
+                aExecutor->setProfiler(profiler);
+            }
+
+            if (memoryBudget > 0)
+            {
+                const double rss = MemoryMonitor::currentRSS();
+                if (rss + maxMemoryGrowth > memoryBudget)
+                    LOG_F(WARNING,
+                          "processor %s may exceed the memory budget %.0lf MB: RSS is %.0lf MB, "
+                          "the largest growth of previous stages is %.0lf MB",
+                          pname.c_str(), memoryBudget, rss, maxMemoryGrowth);
+            }
+            MemoryMonitor memory;
+            memory.start(memorySamplingInterval, trackCurrent); // peak RSS is process-wide for concurrent chains
 
             aExecutor->process(); // must be declared as pointer, otherwise no polymorphism!
-            std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+            if (Executor::interruptRequested()) // all workers have returned, it is safe to flush the checkpoint
+            {
+                handleInterrupt(processors[i]);
+                return;
+            }
+            if (trackCurrent)
+                ProgressChannel::finishStage();
+            const auto end = std::chrono::steady_clock::now();
+            if (trackCurrent and Tracer::enabled())
+                Tracer::complete(pname, "processor", start, end);
+            std::chrono::duration<double, std::milli> duration = end - start;
             VLOG_F(LOGLEVEL_PROGRESS, " ====== processor #%lu  %s completed in %lf seconds =====", i, pname.c_str(),
                    duration.count() / 1000);
+            auto memoryUsage = memory.stop();
+            const double peakRSS = memoryUsage["peakRSS"];
+            maxMemoryGrowth = std::max(maxMemoryGrowth, peakRSS - memoryUsage["startRSS"].get<double>());
+            VLOG_F(LOGLEVEL_PROGRESS, "processor %s peak RSS %.1lf MB, started at %.1lf MB", pname.c_str(), peakRSS,
+                   memoryUsage["startRSS"].get<double>());
+            if (memoryBudget > 0 and peakRSS > memoryBudget)
+                LOG_F(WARNING, "processor %s exceeded the memory budget %.0lf MB", pname.c_str(), memoryBudget);
+            (*info)["memoryUsage"][stageName] = memoryUsage;
+            if (profiler and profiler->size())
+                reportProfile(processors[i], stageName, *profiler, *info);
+            auto te = std::dynamic_pointer_cast<ThreadPoolExecutor>(aExecutor);
+            if (te and te->parallelAccessor())
+                (*info)["dispatchStatistics"][stageName] = te->parallelAccessor()->statistics().information();
         }
     }
 
@@ -1,10 +1,13 @@
 #include "DataObject.h"
+#include "ItemProfiler.h"
 #include "OperatorProxy.h"
 #include "PreCompiled.h"
 #include "Processor.h"
 #include "Utilities.h"
 #include "WorkflowController.h"
 
+#include <future>
+
 #pragma once
 
 
@@ -46,6 +49,25 @@ namespace PPP
         /** prepration before processing, init log, set default names */
         virtual void initialize();
         virtual void computeAll();
+        /// run reader of the input `iData`, nullptr `ds` means using the global data storage
+        std::shared_ptr<DataObject> readInput(size_t iData, std::shared_ptr<DataStorage> ds = nullptr);
+        /// size in MB of the input file `iData`, zero if it is not a local file
+        double inputFileSize(size_t iData) const;
+        /** run a reader or writer stage with a memory monitor, record its usage into `info["memoryUsage"][stageName]`
+         * @param resetPeak  reset the kernel peak RSS, false if other stages run concurrently */
+        void monitorStage(const std::string& stageName, Information& info, bool resetPeak, std::function<void()> stage);
+        /// create the writer for the input `iData`, return nullptr if no writer is configured
+        std::shared_ptr<Processor> createWriter(size_t iData, const std::vector<std::shared_ptr<Processor>>& processors,
+                                                std::shared_ptr<DataObject> data, std::shared_ptr<Information> info);
+        /** run `concurrentInputs` reader->processors->writer chains at the same time,
+         *  inputs are taken from a work queue, largest file first, each chain runs in a TBB arena,
+         *  whose share of `threadsOnNode` is weighted by the estimated work (file size) of the slot.
+         *  Timeline tracing and progress stream are disabled. */
+        void computeConcurrently(size_t concurrentInputs);
+        /// a full chain for one input, with its own processor instances and data storage
+        void computeChain(size_t iData, size_t nCores, std::shared_ptr<DataStorage> ds);
+        /// get the result of a task running in background, log the error instead of stopping other inputs
+        void waitForTask(std::future<void>& f);
         /** save result, log, etc */
         virtual void finalize();
 
@@ -55,15 +77,22 @@ namespace PPP
         virtual void build() override;
         /// process all processors in the pipeline
         void compute(std::shared_ptr<DataObject> data, std::shared_ptr<Information>);
-        /// process Ctrl-C signal
-        void handleSignal(int signum);
+        /// process the given processors in sequence, each processor runs in parallel with `nCores` threads
+        void computeProcessors(std::vector<std::shared_ptr<Processor>>& processors, std::shared_ptr<DataObject> data,
+                               std::shared_ptr<Information> info, size_t nCores);
+        /// write the per-call profile as CSV, and the summary of the slowest calls into `info`,
+        /// `stageName` is the stage index and class name, e.g. "3:Geom::GeometryPropertyBuilder"
+        void reportProfile(std::shared_ptr<Processor> processor, const std::string& stageName,
+                           const ItemProfiler& profiler, Information& info);
+        /// ctrl-C signal handler must be installed in the main thread, it only sets `Executor::interruptRequested()`
+        void installSignalHandler();
+        /// checkpoint and dump the interrupted processor, after its executor has returned
+        void handleInterrupt(std::shared_ptr<Processor> processor);
 
     protected:
         Config myConfig;
 
         std::vector<std::shared_ptr<Processor>> myProcessors;
-        /// current running processor
-        std::shared_ptr<Processor> myCurrentProcessor;
 
         /// the only operator proxy shared by all processors
         std::shared_ptr<OperatorProxy> myOperator;
@@ -168,10 +168,29 @@ namespace PPP
             return false;
         };
 
+        /// indices of items j > i coupled with item i, override to test all pairs of item i in a batch
+        virtual std::vector<ItemIndexType> coupledItems(const ItemIndexType i)
+        {
+            std::vector<ItemIndexType> ids;
+            const ItemIndexType NItems = myInputData->itemCount();
+            for (ItemIndexType j = i + 1; j < NItems; j++)
+            {
+                if (isCoupledPair(i, j))
+                    ids.push_back(j);
+            }
+            return ids;
+        }
+
         /// run in parallelism with the assistance of ParallelAccessor on coupled data
         virtual void processItemPair(const ItemIndexType, const ItemIndexType){};
         /// @}
 
+        /// name of the item used in report and profile summary, derived class may give a meaningful name
+        virtual const std::string itemName(const ItemIndexType index) const
+        {
+            return "item" + std::to_string(index);
+        }
+
 
         /// @{ result group
 
@@ -222,7 +241,17 @@ namespace PPP
 
         bool hasItemReport(const ItemIndexType i) const
         {
-            return myItemReports[i] and myItemReports[i]->str().size();
+            return i < myItemReports.size() and myItemReports[i] and myItemReports[i]->str().size();
+        }
+
+        /// put position of the report of item i, zero if no report, to detect whether a call has appended to it,
+        /// `tellp()` does not copy the report as `str().size()` does
+        std::size_t itemReportSize(const ItemIndexType i) const
+        {
+            if (not hasItemReport(i))
+                return 0;
+            const auto pos = myItemReports[i]->tellp();
+            return pos > 0 ? static_cast<std::size_t>(pos) : 0;
         }
 
         /// must check before use this method
@@ -254,6 +283,24 @@ namespace PPP
             file << (*myInfo); // todo: dump myResult
         }
 
+        /// @{ checkpoint and resume API for time-consuming processors
+        /**
+         * flush checkpoint data, i.e. completed work and modified items, into data storage,
+         * called by the pipeline's signal handler, the default imp does nothing
+         */
+        virtual void checkpoint(){};
+
+        /**
+         * restore the result of completed work from checkpoint data saved by a previous run,
+         * called by executor in resume mode, after `prepareInput()` and before processing.
+         * @return indexers of the completed items or item pairs, to be skipped by executor
+         */
+        virtual std::vector<std::vector<ItemIndexType>> restoreCheckpoint()
+        {
+            return {};
+        }
+        /// @}
+
         /// for debugging output into result data storage folder
         virtual void dumpJson(const json& j, std::string filename)
         {
@@ -279,15 +326,29 @@ namespace PPP
         /// if file name has existed, generate a unique name by timestamp
         std::string dataStoragePath(const std::string& filename) const
         {
-            auto f = Context::dataStorage().getFullPath(filename);
+            auto f = dataStorage().getFullPath(filename);
             if (not fs::exists(f))
                 return f;
             else
             {
                 auto f_ts = Utilities::timeStampFileName(filename);
-                return Context::dataStorage().getFullPath(f_ts);
+                return dataStorage().getFullPath(f_ts);
             }
         }
+
+        /// data storage for the input data being processed, default to the global data storage of Context
+        inline DataStorage& dataStorage() const
+        {
+            if (myDataStorage)
+                return *myDataStorage;
+            return Context::dataStorage();
+        }
+
+        /// set by pipeline controller, if this processor may run while the global storage path has changed
+        void setDataStorage(std::shared_ptr<DataStorage> ds)
+        {
+            myDataStorage = ds;
+        }
         /// @}
 
         std::size_t threadCount()
@@ -533,6 +594,7 @@ namespace PPP
         VectorType<std::shared_ptr<std::stringstream>> myItemReports;
 
         std::shared_ptr<OperatorProxy> myOperator = nullptr; // should be created with nullptr?
+        std::shared_ptr<DataStorage> myDataStorage = nullptr;  /// nullptr means using `Context::dataStorage()`
 
         /// make it a std::vector<> for multiple input
         std::shared_ptr<DataObject> myInputData;  /// it is shared_pointer<>
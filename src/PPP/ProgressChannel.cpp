@@ -0,0 +1,159 @@
+#include "ProgressChannel.h"
+#include "Logger.h"
+
+#include <condition_variable>
+#include <deque>
+
+using namespace PPP;
+
+std::atomic<bool> ProgressChannel::myOpened{false};
+std::atomic<int> ProgressChannel::myActiveWorkers{0};
+
+namespace
+{
+    typedef std::chrono::steady_clock ClockType;
+
+    struct ChannelState
+    {
+        std::mutex mutex;
+        std::ofstream stream;
+        ClockType::duration interval;
+        /// rate is calculated over this number of intervals
+        const size_t windowIntervals = 10;
+
+        /// writes progress lines at fixed intervals, even if no worker makes progress
+        std::thread heartbeat;
+        std::condition_variable stopped;
+
+        bool running = false; /// a stage has started but not finished
+        std::string stage;
+        ClockType::time_point stageStart;
+        ClockType::time_point lastWrite;
+        ClockType::time_point lastChange; /// detected by the line writer, so in the resolution of interval
+        /// published by workers without lock
+        std::atomic<size_t> done{0};
+        std::atomic<size_t> total{0};
+        size_t lastDone = 0; /// `done` of the last line
+        /// (time, done) samples in the sliding window
+        std::deque<std::pair<ClockType::time_point, size_t>> window;
+    };
+
+    ChannelState& state()
+    {
+        static ChannelState s;
+        return s;
+    }
+
+    /// must be called with the state mutex locked
+    void writeLine(ChannelState& s, const char* event, const ClockType::time_point now, const int activeWorkers)
+    {
+        const size_t done = s.done.load(std::memory_order_relaxed);
+        const size_t total = s.total.load(std::memory_order_relaxed);
+        if (done != s.lastDone)
+            s.lastChange = now;
+        s.lastDone = done;
+        s.window.emplace_back(now, done);
+        while (s.window.size() > 2 && now - s.window.front().first > s.interval * s.windowIntervals)
+            s.window.pop_front();
+        const auto& first = s.window.front();
+        const std::chrono::duration<double> span = now - first.first;
+        const double progressed = double(done) - double(first.second);
+        const double rate = span.count() > 0 ? std::max(progressed, 0.0) / span.count() : 0.0;
+
+        const std::chrono::duration<double> elapsed = now - s.stageStart;
+        const std::chrono::duration<double> stalled = now - s.lastChange;
+        const std::chrono::duration<double> epoch = std::chrono::system_clock::now().time_since_epoch();
+        Information line = {{"time", epoch.count()},
+                            {"stage", s.stage},
+                            {"event", event},
+                            {"done", done},
+                            {"total", total},
+                            {"elapsed", elapsed.count()},
+                            {"rate", rate},
+                            {"eta", nullptr},
+                            {"stalled", stalled.count()},
+                            {"activeWorkers", activeWorkers}};
+        if (rate > 0)
+            line["eta"] = double(total > done ? total - done : 0) / rate;
+        s.stream << line.dump() << std::endl; // flush, so the consumer can tail the file
+        s.lastWrite = now;
+    }
+
+    void heartbeatLoop(const std::atomic<bool>& opened, const std::atomic<int>& activeWorkers)
+    {
+        auto& s = state();
+        std::unique_lock<std::mutex> lock(s.mutex);
+        while (opened)
+        {
+            s.stopped.wait_for(lock, s.interval);
+            const auto now = ClockType::now();
+            if (opened and s.running and now - s.lastWrite >= s.interval)
+                writeLine(s, "progress", now, activeWorkers);
+        }
+    }
+} // namespace
+
+void ProgressChannel::open(const std::string& filename, const double interval)
+{
+    close();
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.stream.open(filename, std::ios::out | std::ios::app);
+    s.interval = std::chrono::duration_cast<ClockType::duration>(std::chrono::duration<double>(interval));
+    myOpened = s.stream.is_open();
+    if (myOpened)
+        s.heartbeat = std::thread(heartbeatLoop, std::cref(myOpened), std::cref(myActiveWorkers));
+    else
+        LOG_F(ERROR, "failed to open progress file `%s`", filename.c_str());
+}
+
+void ProgressChannel::close()
+{
+    auto& s = state();
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        myOpened = false;
+        s.running = false;
+    }
+    s.stopped.notify_all();
+    if (s.heartbeat.joinable())
+        s.heartbeat.join();
+    s.stream.close();
+}
+
+void ProgressChannel::startStage(const std::string& stage, const size_t total, const size_t done)
+{
+    if (not opened())
+        return;
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    const auto now = ClockType::now();
+    s.stage = stage;
+    s.stageStart = now;
+    s.lastChange = now;
+    s.lastDone = done;
+    s.done = done;
+    s.total = total;
+    s.window.clear();
+    s.running = true;
+    writeLine(s, "start", now, myActiveWorkers);
+}
+
+void ProgressChannel::finishStage()
+{
+    if (not opened())
+        return;
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    const auto now = ClockType::now();
+    s.done = s.total.load();
+    s.running = false;
+    writeLine(s, "finish", now, myActiveWorkers);
+}
+
+void ProgressChannel::update(const size_t done)
+{
+    if (not opened())
+        return;
+    state().done.store(done, std::memory_order_relaxed);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "PreCompiled.h"
+#include "TypeDefs.h"
+
+namespace PPP
+{
+
+    /// \ingroup PPP
+    /** machine-readable progress stream, one JSON object per line (JSON-lines)
+     *
+     * Each line has the fields: `time` (Unix epoch seconds), `stage` (processor name),
+     * `event` ("start", "progress" or "finish"), `done` and `total` counts, `elapsed` seconds since stage start,
+     * `rate` (done per second over a sliding window), `eta` (seconds, null if rate is zero),
+     * `stalled` (seconds since `done` last changed) and `activeWorkers`.
+     *
+     * Progress lines are written by a heartbeat thread at fixed time intervals, rather than percentage steps,
+     * so the consumer (job scheduler) can predict completion and detect stalls, even if all workers are stuck.
+     * It is opened by `PipelineController::compute()` if `progressFile` is set in the `parallelism` config section,
+     * coupled stages report via `Progressor::remain()`.
+     *
+     * `done` and `total` are counted in one unit per stage: items by default, item pairs for a coupled stage,
+     * the executor starts the stage once it knows the unit, so the total of the "start" line is never replaced.
+     * Workers publish counts by atomic stores without lock, only the heartbeat thread and stage start/finish
+     * take the mutex, so a slow write of the progress file never blocks the dispatcher.
+     */
+    class AppExport ProgressChannel
+    {
+    public:
+        /// @param interval  minimum seconds between two progress lines of the same stage
+        static void open(const std::string& filename, const double interval = 1.0);
+        static void close();
+        inline static bool opened()
+        {
+            return myOpened.load(std::memory_order_relaxed);
+        }
+
+        /// write a "start" line and reset the sliding window, `done` may be restored from checkpoint
+        static void startStage(const std::string& stage, const size_t total, const size_t done = 0);
+        /// write a "finish" line, `done` is set to `total`
+        static void finishStage();
+        /// update the done count of the current stage, lock-free, written by the next heartbeat
+        static void update(const size_t done);
+
+        static void workerStarted()
+        {
+            myActiveWorkers++;
+        }
+        static void workerFinished()
+        {
+            myActiveWorkers--;
+        }
+
+    private:
+        static std::atomic<bool> myOpened;
+        static std::atomic<int> myActiveWorkers;
+    };
+
+    /// RAII counter of active workers, for the lifetime of a worker task
+    class ActiveWorker
+    {
+    public:
+        ActiveWorker()
+        {
+            ProgressChannel::workerStarted();
+        }
+        ActiveWorker(const ActiveWorker&) = delete;
+        ~ActiveWorker()
+        {
+            ProgressChannel::workerFinished();
+        }
+    };
+
+} // namespace PPP
@@ -2,6 +2,7 @@
 
 #include "Logger.h"
 #include "PreCompiled.h"
+#include "ProgressChannel.h"
 
 namespace PPP
 {
@@ -41,9 +42,11 @@ namespace PPP
             myReportInterval = size_t(myTotalSteps / myReportFrequency);
         }
 
-        /// report progress to log stream, external graphic progress monitor will parse the log
+        /// report progress to log stream, external graphic progress monitor will parse the log,
+        /// and to the structured progress channel if opened
         void remain(size_t remained_step)
         {
+            ProgressChannel::update(myTotalSteps - remained_step);
             if (myRemainedSteps - remained_step > myReportInterval)
             {
                 myRemainedSteps = remained_step;
@@ -4,9 +4,11 @@
 #include "CouplingMatrixBuilder.h"
 #include "Executor.h"
 #include "ParallelAccessor.h"
+#include "ProgressChannel.h"
 
 #define PPP_HAS_TBB 1
 #if PPP_HAS_TBB
+#include "tbb/task_arena.h"
 #include "tbb/task_group.h"
 typedef tbb::task_group ThreadPoolType;
 #else
@@ -42,6 +44,12 @@ namespace PPP
             myParallelAccessor = pa;
         }
 
+        /// the accessor used by coupled processing, nullptr for uncoupled processor
+        std::shared_ptr<const ParallelAccessor> parallelAccessor() const
+        {
+            return myParallelAccessor;
+        }
+
         /**
          *  this algorithm needs only the length of data
          */
@@ -51,7 +59,10 @@ namespace PPP
         //
         virtual void process() override
         {
-            myProcessor->prepareInput();
+            {
+                TraceSpan span("prepareInput", "stage");
+                myProcessor->prepareInput();
+            }
             const size_t NItems = myProcessor->inputData()->itemCount();
             if (NItems == 0)
             {
@@ -64,6 +75,7 @@ namespace PPP
             if (ip == IndexPattern::PartitionIdVector)
             {
                 VLOG_F(LOGLEVEL_DEBUG, " processing item in parallel using partitioned Id");
+                startProgress(NItems);
                 runParallelOnPartitionedData();
             }
             else if (myParallelAccessor || myProcessor->isCoupledOperation())
@@ -73,6 +85,9 @@ namespace PPP
                 {
                     generateParallelAccessor(dim); // ip == FilteredMatrix, SparseMatrix
                 }
+                // item pairs, those restored from checkpoint are done
+                const size_t nPairs = myParallelAccessor->operationSize();
+                startProgress(nPairs, nPairs - myParallelAccessor->remainedOperationSize());
 
                 if (myParallelAccessor->synchronized())
                 {
@@ -82,17 +97,32 @@ namespace PPP
                 {
                     runAsynchronouslyOnCoupledData(myParallelAccessor);
                 }
+                logDispatchStatistics(myParallelAccessor->statistics());
             }
             else
             {
+                startProgress(NItems);
                 runParallelInBlock(NItems);
                 /// NOTE: asyn mode could be more efficient, if processItem() time is not constant
             }
 
+            if (interruptRequested())
+                return; // partial result, the caller will checkpoint
+            TraceSpan span("prepareOutput", "stage");
             myProcessor->prepareOutput();
         }
 
     private:
+        /// summary at the end of coupled stage, to tune batch size and worker count
+        void logDispatchStatistics(const ParallelAccessor::DispatchStatistics& st) const
+        {
+            LOG_F(INFO,
+                  "dispatcher: %lu next() calls (%lu empty), mean latency %.1lf us, lock wait %.3lf seconds; "
+                  "%lu scans visited %lu indexers, %lu skipped as locked",
+                  st.nextCount, st.emptyCount, st.nextCount ? st.dispatchTime / st.nextCount * 1e6 : 0.0,
+                  st.lockWaitTime, st.scanCount, st.scannedCount, st.skippedCount);
+        }
+
         void generateParallelAccessor(const size_t dim)
         {
             // AsynchronousDispatcher is the preferred one
@@ -127,6 +157,14 @@ namespace PPP
                 pa->setCouplingMatrix(cmat);
                 cmat.writeMatrixMarketFile(myProcessor->generateDumpName("myFilteredMatrix.mm", {})); // debugging
             }
+
+            if (myProcessor->dataStorage().resumeMode())
+            {
+                auto completed = myProcessor->restoreCheckpoint();
+                auto nSkipped = pa->removeCompletedItems(completed);
+                LOG_F(INFO, "resume mode: %lu completed item pairs are restored from checkpoint, %lu remain", nSkipped,
+                      pa->remainedOperationSize());
+            }
             myParallelAccessor = pa;
         }
 
@@ -160,11 +198,13 @@ namespace PPP
                 }
                 // it is important to capture the index by value
                 myThreadPool->run([&, i_start = i_start, i_end = i_end]() {
+                    TraceSpan span("task", "worker");
+                    ActiveWorker worker;
                     for (size_t i = i_start; i < i_end && i < NItems; i++)
                     {
                         if (this->myReporter)
                             this->myReporter(i);
-                        this->myProcessor->processItem(i);
+                        this->runItem(i);
                     }
                 });
             }
@@ -193,10 +233,12 @@ namespace PPP
                 if (ids.size())
                 {
                     myThreadPool->run([=]() {
+                        TraceSpan span("task", "worker");
+                        ActiveWorker worker;
                         for (auto index : ids) // must pass ids as value into this lambda function
                         {
                             // LOG_F(INFO, "partition id %d", index);
-                            myProcessor->processItem(index);
+                            runItem(index);
                         }
                     });
                 }
@@ -220,12 +262,14 @@ namespace PPP
                 {
                     /// NOTE: it is fine to capture ids by reference, but workerId must be passed by value copy
                     myThreadPool->run([&, t = workerId]() {
+                        TraceSpan span("task", "worker");
+                        ActiveWorker worker;
                         for (auto indexer : ids[t]) // if there is no indexer, this worker will do nothing
                         {
                             if (dim == 2)
-                                myProcessor->processItemPair(indexer[0], indexer[1]);
+                                runItemPair(indexer[0], indexer[1]);
                             else
-                                myProcessor->processItem(indexer[0]);
+                                runItem(indexer[0]);
                         }
                     });
                 }
@@ -243,15 +287,17 @@ namespace PPP
             for (unsigned int t = 0; t < myWorkerCount; t++)
             {
                 myThreadPool->run([&]() {
+                    TraceSpan span("task", "worker");
+                    ActiveWorker worker;
                     auto ids = pa->next(); /// protected by std::mutex
                     while (ids.size() > 0)
                     {
                         for (auto indexer : ids) // if there is no indexer, this worker will do nothing
                         {
                             if (dim == 2)
-                                myProcessor->processItemPair(indexer[0], indexer[1]);
+                                runItemPair(indexer[0], indexer[1]);
                             else
-                                myProcessor->processItem(indexer[0]);
+                                runItem(indexer[0]);
                             // loglevel 1 means PROGRESS,  disable this info since progress bar is available
                             // VLOG_F(PROGRESS, "processing pair (%lu, %lu) asynchronously", indexer[0], indexer[1]);
                         }
@@ -0,0 +1,116 @@
+#include "Tracer.h"
+
+using namespace PPP;
+
+std::atomic<bool> Tracer::myEnabled{false};
+
+namespace
+{
+    struct TraceEvent
+    {
+        std::string name;
+        const char* category;
+        Tracer::ClockType::time_point start;
+        Tracer::ClockType::duration duration;
+        ItemIndexType i;
+        ItemIndexType j;
+    };
+
+    /// events of one thread, owned by the registry, so the buffer outlives the thread
+    struct TraceBuffer
+    {
+        size_t tid;
+        std::thread::id threadId;
+        std::vector<TraceEvent> events;
+    };
+
+    struct TraceRegistry
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<TraceBuffer>> buffers;
+        Tracer::ClockType::time_point startTime = Tracer::ClockType::now();
+        std::thread::id mainThread;
+    };
+
+    TraceRegistry& registry()
+    {
+        static TraceRegistry r;
+        return r;
+    }
+
+    /// the buffer of the calling thread, registered at the first event of this thread
+    TraceBuffer& threadBuffer()
+    {
+        thread_local TraceBuffer* buffer = nullptr;
+        if (not buffer)
+        {
+            auto& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.buffers.push_back(std::make_unique<TraceBuffer>());
+            buffer = r.buffers.back().get();
+            buffer->tid = r.buffers.size();
+            buffer->threadId = std::this_thread::get_id();
+        }
+        return *buffer;
+    }
+} // namespace
+
+void Tracer::start()
+{
+    auto& r = registry();
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (auto& b : r.buffers)
+            b->events.clear();
+        r.startTime = ClockType::now();
+        r.mainThread = std::this_thread::get_id();
+    }
+    myEnabled = true;
+}
+
+void Tracer::stop()
+{
+    myEnabled = false;
+}
+
+void Tracer::complete(const std::string& name, const char* category, const ClockType::time_point& start,
+                      const ClockType::time_point& end, const ItemIndexType i, const ItemIndexType j)
+{
+    threadBuffer().events.push_back({name, category, start, end - start, i, j});
+}
+
+void Tracer::write(const std::string& filename)
+{
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::ofstream ofs(filename);
+    ofs << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    bool first = true;
+    for (const auto& b : r.buffers)
+    {
+        if (b->events.empty())
+            continue;
+        // metadata event to name the thread row in viewer
+        const std::string threadName = b->threadId == r.mainThread ? "main" : "worker " + std::to_string(b->tid);
+        ofs << (first ? "" : ",\n") << R"({"name": "thread_name", "ph": "M", "pid": 1, "tid": )" << b->tid
+            << R"(, "args": {"name": ")" << threadName << "\"}}";
+        first = false;
+        for (const auto& e : b->events)
+        {
+            const std::chrono::duration<double, std::micro> ts = e.start - r.startTime;
+            const std::chrono::duration<double, std::micro> dur = e.duration;
+            ofs << ",\n{\"name\": " << json(e.name).dump() << ", \"cat\": \"" << e.category
+                << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << b->tid << ", \"ts\": " << ts.count()
+                << ", \"dur\": " << dur.count();
+            if (e.i != NoItem)
+            {
+                ofs << ", \"args\": {\"i\": " << e.i;
+                if (e.j != NoItem)
+                    ofs << ", \"j\": " << e.j;
+                ofs << "}";
+            }
+            ofs << "}";
+        }
+    }
+    ofs << "\n]}\n";
+}
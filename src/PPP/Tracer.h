@@ -0,0 +1,81 @@
+#pragma once
+
+#include "PreCompiled.h"
+#include "TypeDefs.h"
+
+namespace PPP
+{
+
+    /// \ingroup PPP
+    /** process-wide timeline recorder, exported as Chrome trace-event JSON,
+     * which can be loaded into `chrome://tracing` or <https://ui.perfetto.dev>
+     *
+     * Each span is a complete event ("ph": "X") on the thread recording it, so idle gaps between spans,
+     * serial stages and tail stragglers are visible directly in the viewer.
+     * Events are appended into the buffer of the calling thread without lock,
+     * when tracing is disabled, the cost of a span is a single atomic load.
+     *
+     * `start()`, `stop()` and `write()` should be called in the main thread when no worker is running,
+     * by `PipelineController::compute()` if `traceFile` is set in the `parallelism` config section.
+     */
+    class AppExport Tracer
+    {
+    public:
+        typedef std::chrono::steady_clock ClockType;
+        static constexpr ItemIndexType NoItem = std::numeric_limits<ItemIndexType>::max();
+
+        /// clear events recorded previously, and start recording
+        static void start();
+        static void stop();
+        inline static bool enabled()
+        {
+            return myEnabled.load(std::memory_order_relaxed);
+        }
+
+        /// record a span on the calling thread, item indices are written as event args if given
+        static void complete(const std::string& name, const char* category, const ClockType::time_point& start,
+                             const ClockType::time_point& end, const ItemIndexType i = NoItem,
+                             const ItemIndexType j = NoItem);
+
+        /// write all recorded events into a JSON file in trace-event format
+        static void write(const std::string& filename);
+
+    private:
+        static std::atomic<bool> myEnabled;
+    };
+
+    /// RAII span, recorded at destruction if tracing is enabled at construction
+    class TraceSpan
+    {
+    private:
+        const char* myName;
+        const char* myCategory;
+        const ItemIndexType myI;
+        const ItemIndexType myJ;
+        const bool myEnabled;
+        Tracer::ClockType::time_point myStart;
+
+    public:
+        /// name and category must be string literals
+        TraceSpan(const char* name, const char* category, const ItemIndexType i = Tracer::NoItem,
+                  const ItemIndexType j = Tracer::NoItem)
+                : myName(name)
+                , myCategory(category)
+                , myI(i)
+                , myJ(j)
+                , myEnabled(Tracer::enabled())
+        {
+            if (myEnabled)
+                myStart = Tracer::ClockType::now();
+        }
+
+        TraceSpan(const TraceSpan&) = delete;
+
+        ~TraceSpan()
+        {
+            if (myEnabled)
+                Tracer::complete(myName, myCategory, myStart, Tracer::ClockType::now(), myI, myJ);
+        }
+    };
+
+} // namespace PPP
@@ -1,16 +1,31 @@
 #pragma once
 
+#include <cassert>
 #include <iomanip>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
 
-/// using TBB current hash map for thread-safety
+/// using TBB current hash map for thread-safety, enabled by cmake option `PPP_USE_CONCURRENT_PROPERTY`
 #if USE_CONCURRENT_HASH_CONTAINER
 #include <tbb/concurrent_hash_map.h>
 template <class Key, class Value> using HashContainer = tbb::concurrent_hash_map<Key, Value>;
+typedef std::shared_mutex PropertySlotMutex;
 #else
 #include <map>
 #include <unordered_map>
 template <class Key, class Value> using HashContainer = std::unordered_map<Key, Value>;
+/// no-op mutex, zero overhead in the single thread mode
+struct PropertySlotMutex
+{
+    void lock() {}
+    void unlock() {}
+    void lock_shared() {}
+    void unlock_shared() {}
+};
 #endif
 
 /// macro options
@@ -62,6 +77,82 @@ namespace PPP
     }
 
     /// \ingroup PPP
+    /**
+     * registry to map property name to a slot index, shared by all PropertyContainer instances.
+     * A name is registered once, when it is first seen by `PropertyKey<T>` or by string key setters,
+     * so the same name has the same slot index in all containers.
+     */
+    class PropertySlots
+    {
+    public:
+        static std::size_t slot(const std::string& name)
+        {
+            std::lock_guard<std::mutex> lock(registryMutex());
+            auto& r = registry();
+            auto it = r.find(name);
+            if (it != r.end())
+                return it->second;
+            std::size_t i = r.size();
+            r.emplace(name, i);
+            return i;
+        }
+
+        /// return `npos` if the name has not been registered, without registering it
+        static std::size_t find(const std::string& name)
+        {
+            std::lock_guard<std::mutex> lock(registryMutex());
+            auto& r = registry();
+            auto it = r.find(name);
+            return it != r.end() ? it->second : npos;
+        }
+
+        static const std::size_t npos = static_cast<std::size_t>(-1);
+
+    private:
+        static std::unordered_map<std::string, std::size_t>& registry()
+        {
+            static std::unordered_map<std::string, std::size_t> r;
+            return r;
+        }
+        static std::mutex& registryMutex()
+        {
+            static std::mutex m;
+            return m;
+        }
+    };
+
+    /**
+     * typed property handle, the name is resolved into a slot index only once at construction.
+     * Access by this key is O(1) indexing without string hashing or `any_cast`, while string keys
+     * remain available for Python and json.
+     *
+     * usage: `inline const PropertyKey<std::vector<int>> myKey{"myKey"};` then `container.get(myKey)`
+     */
+    template <typename T> class PropertyKey
+    {
+    public:
+        typedef T value_type;
+
+        explicit PropertyKey(const std::string& name)
+                : myName(name)
+                , mySlot(PropertySlots::slot(name))
+        {
+        }
+
+        inline const std::string& name() const
+        {
+            return myName;
+        }
+        inline std::size_t slot() const
+        {
+            return mySlot;
+        }
+
+    private:
+        std::string myName;
+        std::size_t mySlot;
+    };
+
     /**
      * dynamic heterogeneous container to simulate dynamic property, based on std::any
      *
@@ -70,12 +161,33 @@ namespace PPP
      * Public access can only access pointer or value to the Property.data of specific type.
      *
      * Data saved into std::any are `shared_ptr<T>`, to avoid large data copying around
+     *
+     * Concurrent mode (compiled with `USE_CONCURRENT_HASH_CONTAINER`):
+     * `set/emplace/erase/extract/get/getConst/contains` can be called from multiple threads.
+     * Properties are stored in `tbb::concurrent_hash_map`, each lookup copies the `shared_ptr` under
+     * the element lock, so a property replaced by another thread is still alive for its reader.
+     * Memory ordering: publishing a property (`set()`) happens-before any `get()` which observes it,
+     * as both sides synchronize on the same lock (release on unlock, acquire on lock);
+     * therefore data fully constructed before `set()` is visible to all readers.
+     * The content of a published property is NOT protected, publish a new property instead of mutating it,
+     * unless the data type itself is thread-safe or all writers are joined before readers start.
+     * Iteration by `save()`, `size()` and move construction must not run concurrently with writers.
      */
     class PropertyContainer
     {
     protected:
         HashContainer<std::string, Property> myProperties;
 
+        /// typed view of property data indexed by slot, kept in sync with `myProperties` by all setters
+        struct SlotEntry
+        {
+            std::shared_ptr<void> data;
+            std::type_index type = typeid(void);
+        };
+        std::vector<SlotEntry> mySlots;
+        /// protect `mySlots` in concurrent mode, readers take the shared lock
+        mutable PropertySlotMutex mySlotMutex;
+
         typedef std::string key_type;
         typedef HashContainer<std::string, Property>::const_iterator const_iterator_type;
 
@@ -86,6 +198,90 @@ namespace PPP
         typedef std::string DataPath;
 
     protected:
+        /// only `std::shared_ptr<T>` pointer type can be viewed by slot
+        template <typename T, typename Ptr> void updateSlot(const std::string& key, const Ptr& pdata)
+        {
+            const std::size_t i = PropertySlots::slot(key);
+            std::unique_lock<PropertySlotMutex> lock(mySlotMutex);
+            if (i >= mySlots.size())
+                mySlots.resize(i + 1);
+            mySlots[i].data = std::const_pointer_cast<void>(std::static_pointer_cast<const void>(pdata));
+            mySlots[i].type = typeid(typename std::remove_const<T>::type);
+        }
+
+        /// caller must hold `mySlotMutex`, throw if the slot is empty or holds data of another type
+        template <typename T> void checkSlot(const PropertyKey<T>& key) const
+        {
+            if (key.slot() >= mySlots.size() || not mySlots[key.slot()].data)
+                throw std::runtime_error("no property named as: " + key.name());
+            if (mySlots[key.slot()].type != typeid(typename std::remove_const<T>::type))
+                throw std::runtime_error("property `" + key.name() + "` is not of the type of the key, but " +
+                                         demangle(mySlots[key.slot()].type.name()));
+        }
+
+        void clearSlot(const std::string& key)
+        {
+            const std::size_t i = PropertySlots::find(key);
+            std::unique_lock<PropertySlotMutex> lock(mySlotMutex);
+            if (i < mySlots.size()) // also false for `PropertySlots::npos`
+                mySlots[i] = SlotEntry();
+        }
+
+        /// copy the property data (a shared_ptr in `any`) into `data`, return false if not found
+        bool findData(const std::string& key, any& data) const
+        {
+#if USE_CONCURRENT_HASH_CONTAINER
+            typename HashContainer<std::string, Property>::const_accessor a; // read lock on this element
+            if (not myProperties.find(a, key))
+                return false;
+            data = a->second.data;
+#else
+            auto it = myProperties.find(key);
+            if (it == myProperties.end())
+                return false;
+            data = it->second.data;
+#endif
+            return true;
+        }
+
+        /// insert or replace the property, slot view is updated within the element lock
+        template <typename T, typename Ptr> void insertProperty(const std::string& key, Property&& p, const Ptr& pdata)
+        {
+#if USE_CONCURRENT_HASH_CONTAINER
+            typename HashContainer<std::string, Property>::accessor a; // write lock on this element
+            myProperties.insert(a, key);
+            a->second = std::move(p);
+#else
+            myProperties.insert_or_assign(key, std::move(p));
+#endif
+            updateSlot<T>(key, pdata);
+        }
+
+        /// return false if not found, the data is moved into `data` if it is not nullptr
+        bool removeProperty(const std::string& key, any* data = nullptr)
+        {
+#if USE_CONCURRENT_HASH_CONTAINER
+            typename HashContainer<std::string, Property>::accessor a;
+            if (not myProperties.find(a, key))
+                return false;
+            if (data)
+                *data = std::move(a->second.data);
+            clearSlot(key);
+            myProperties.erase(a);
+#else
+            auto it = myProperties.find(key);
+            if (it == myProperties.end())
+                return false;
+            if (data)
+                *data = std::move(it->second.data);
+            clearSlot(key);
+            myProperties.erase(it);
+#endif
+            return true;
+        }
+
+#if not USE_CONCURRENT_HASH_CONTAINER
+        /// reference to property is not safe in concurrent mode, as it can be erased by other threads
         /**  enforced move semantics, this container must have the ownership of property*/
         void addProperty(const Property&& p)
         {
@@ -115,6 +311,7 @@ namespace PPP
                 throw std::runtime_error("key not found in this container");
             }
         }
+#endif
 
     public:
         PropertyContainer() = default;
@@ -124,17 +321,51 @@ namespace PPP
 
         PropertyContainer(PropertyContainer&& pc)
                 : myProperties(std::move(pc.myProperties))
+                , mySlots(std::move(pc.mySlots))
+        {
+        }
+
+        /// @{ typed key API, O(1) access by slot index
+        template <typename T> inline bool contains(const PropertyKey<T>& key) const
+        {
+            std::shared_lock<PropertySlotMutex> lock(mySlotMutex);
+            return key.slot() < mySlots.size() && mySlots[key.slot()].data;
+        }
+
+        /// throw if the property does not exist or was set with another type under the same name, as `any_cast` does
+        template <typename T> default_pointer_type<T> get(const PropertyKey<T>& key)
         {
+            std::shared_lock<PropertySlotMutex> lock(mySlotMutex);
+            checkSlot(key);
+            return std::static_pointer_cast<T>(mySlots[key.slot()].data);
         }
 
+        template <typename T> default_pointer_type<const T> getConst(const PropertyKey<T>& key) const
+        {
+            std::shared_lock<PropertySlotMutex> lock(mySlotMutex);
+            checkSlot(key);
+            return std::static_pointer_cast<const T>(mySlots[key.slot()].data);
+        }
+
+        template <typename T> void set(const PropertyKey<T>& key, default_pointer_type<T> pdata)
+        {
+            set<T>(key.name(), pdata);
+        }
+
+        template <typename T> void emplace(const PropertyKey<T>& key, T&& data)
+        {
+            set<T>(key.name(), std::make_shared<T>(std::move(data)));
+        }
+        /// @}
+
         /// @{
         /** get property data by key name, return a `std::shared_ptr<T>` to the property data
          */
         template <typename T> default_pointer_type<T> get(const std::string& key)
         {
-            if (contains(key))
+            any an;
+            if (findData(key, an)) // single lookup, as the key may be erased by another thread after contains()
             {
-                any an = myProperties[key].data;
                 return any_cast<default_pointer_type<T>>(an);
             }
             else
@@ -146,10 +377,9 @@ namespace PPP
         /// get the data also erase it from the container
         template <typename T, typename Ptr = default_pointer_type<T>> Ptr extract(const std::string& key)
         {
-            if (contains(key))
+            any an;
+            if (removeProperty(key, &an))
             {
-                any an = myProperties[key].data;
-                myProperties.erase(key);
                 return any_cast<default_pointer_type<T>>(an);
             }
             else
@@ -164,10 +394,10 @@ namespace PPP
         template <typename T, typename = std::enable_if<std::is_const<T>::value>>
         default_pointer_type<T> get(const std::string& key) const
         {
-            std::cout << "DEBUG info: const version of get<const AType>() is called!" << std::endl;
-            if (contains(key))
+            any an;
+            if (findData(key, an))
             {
-                return any_cast<default_pointer_type<T>>(myProperties.at(key).data);
+                return any_cast<default_pointer_type<T>>(an);
             }
             else
             {
@@ -179,10 +409,10 @@ namespace PPP
          * */
         template <typename T> T getValue(const std::string& key) const
         {
-            std::cout << "DEBUG info: const version of get<const AType>() is called!" << std::endl;
-            if (contains(key))
+            any an;
+            if (findData(key, an))
             {
-                auto ptr = any_cast<default_pointer_type<const T>>(myProperties.at(key).data);
+                auto ptr = any_cast<default_pointer_type<const T>>(an);
                 return T(*ptr);
             }
             else
@@ -195,9 +425,10 @@ namespace PPP
          * */
         template <typename T> default_pointer_type<const T> getConst(const std::string& key) const
         {
-            if (contains(key))
+            any an;
+            if (findData(key, an))
             {
-                return any_cast<default_pointer_type<T>>(myProperties.at(key).data);
+                return any_cast<default_pointer_type<T>>(an);
             }
             else
             {
@@ -219,7 +450,6 @@ namespace PPP
         template <class DType, typename = std::enable_if<std::is_rvalue_reference<DType>::value>>
         void set(const std::string& key, DType data)
         {
-            std::cout << "DEBUG info: set() with std::enable_if<std::is_rvalue_reference<T>::value>" << std::endl;
             typename std::remove_reference<DType>::type realType;
             set<decltype(realType)>(key, std::make_shared<decltype(realType)>(std::move(data)));
         }
@@ -238,14 +468,10 @@ namespace PPP
          */
         template <typename T, typename Ptr = default_pointer_type<T>> void set(const std::string& key, Ptr pdata)
         {
-            if (contains(key))
-            {
-                myProperties.erase(key);
-            }
             auto typeName = demangle(typeid(*pdata).name()); // from pointer type to object type
             Property p(key, any(pdata), typeName, nullptr);
             p.setFlag(PropertyFlag::Transient); // this name may be not good enough, subjective to change
-            myProperties.emplace(key, std::move(p));
+            insertProperty<T>(key, std::move(p), pdata); // replace if the key has existed
         }
 
         /** accept only rvalue, produced by std::move(your_type)
@@ -253,7 +479,6 @@ namespace PPP
         template <class T, typename = std::enable_if<std::is_rvalue_reference<T>::value>>
         void setSerializable(const std::string& key, T data, Jsonizer _jsonizer = nullptr)
         {
-            std::cout << "set() with std::enable_if<std::is_rvalue_reference<T>::value>" << std::endl;
             typename std::remove_reference<T>::type realType;
             Jsonizer jsonizer;
             if (!_jsonizer)
@@ -279,23 +504,15 @@ namespace PPP
         template <typename T, typename Ptr = default_pointer_type<T>>
         void setSerializable(const std::string& key, Ptr pdata, Jsonizer jsonizer = anyToJson<T>)
         {
-            if (contains(key))
-            {
-                myProperties.erase(key);
-            }
             auto typeName = demangle(typeid(*pdata).name()); // from pointer type to object type
             Property p(key, any(pdata), typeName, jsonizer);
-            myProperties.emplace(key, std::move(p));
+            insertProperty<T>(key, std::move(p), pdata);
         }
 
         /// if the key existed, erase first
         template <typename T, typename Ptr = default_pointer_type<T>>
         void setSerializable(const std::string& key, Ptr pdata, const DataPath& _path)
         {
-            if (contains(key))
-            {
-                myProperties.erase(key);
-            }
             auto typeName = demangle(typeid(*pdata).name()); // from pointer type to object type
 
             Jsonizer jsonizer = [&_path](any&) { return _path; };
@@ -304,7 +521,7 @@ namespace PPP
                 p.setFlag(PropertyFlag::ExternalLink); // this name may be not good enough, subjective to change
             else
                 p.setFlag(PropertyFlag::Transient); // this name may be not good enough, subjective to change
-            myProperties.emplace(key, std::move(p));
+            insertProperty<T>(key, std::move(p), pdata);
         }
 
 
@@ -325,12 +542,12 @@ namespace PPP
         /** bring C++20 STL to this class */
         inline bool contains(const std::string& key) const
         {
-            return myProperties.find(key) != myProperties.end();
+            return myProperties.count(key) > 0; // `find() != end()` is not available for concurrent_hash_map
         }
         /** no effect if no such key  */
         inline void erase(const std::string& key) noexcept
         {
-            myProperties.erase(key);
+            removeProperty(key);
         }
 
         void save(const std::string filename)
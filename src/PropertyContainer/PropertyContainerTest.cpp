@@ -208,3 +208,71 @@ TEST_CASE_METHOD(PropertyContainerTest, "json serialization test", "[multi-file:
     REQUIRE(j["D"]["data"].size() == length);
     REQUIRE(j["E"]["data"] == filepath);
 }
+
+TEST_CASE_METHOD(PropertyContainerTest, "typed property key test", "[multi-file:8]")
+{
+    using Data = std::vector<int>;
+    static const PropertyKey<Data> key("typedKeyData");
+    std::size_t length = 5;
+
+    PropertyContainer d;
+    REQUIRE(d.contains(key) == false);
+    d.emplace(key, Data(length, 1));
+    REQUIRE(d.contains(key));
+    REQUIRE(d.get(key)->size() == length);
+    REQUIRE(d.getConst(key)->size() == length);
+
+    // string key API and typed key API view the same data
+    d.get<Data>("typedKeyData")->push_back(2);
+    REQUIRE(d.get(key)->size() == length + 1);
+    d.set<Data>("typedKeyData", std::make_shared<Data>(length * 2));
+    REQUIRE(d.get(key)->size() == length * 2);
+
+    // the same name has the same slot, even it is declared later
+    PropertyKey<Data> key2("typedKeyData");
+    REQUIRE(key2.slot() == key.slot());
+    REQUIRE(d.get(key2)->size() == length * 2);
+    // a key of another type but the same name must not cast the data
+    const PropertyKey<std::vector<double>> wrongKey("typedKeyData");
+    REQUIRE_THROWS(d.get(wrongKey));
+    REQUIRE_THROWS(d.getConst(wrongKey));
+
+    d.erase(key.name());
+    REQUIRE(d.contains(key) == false);
+    REQUIRE_THROWS(d.get(key));
+}
+
+#if USE_CONCURRENT_HASH_CONTAINER
+#include <atomic>
+#include <thread>
+TEST_CASE_METHOD(PropertyContainerTest, "concurrent read and write test", "[multi-file:9]")
+{
+    using Data = std::vector<int>;
+    static const PropertyKey<Data> key("concurrentData");
+    PropertyContainer d;
+    d.emplace(key, Data(1, 0));
+
+    const int nThreads = 8;
+    std::atomic<int> failures{0}; // Catch2 assertion macros are not thread-safe, check in main thread after join
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nThreads; t++)
+    {
+        threads.emplace_back([&d, &failures, t]() {
+            for (int i = 0; i < 1000; i++)
+            {
+                std::string k = "thread" + std::to_string(t);
+                d.set<Data>(k, std::make_shared<Data>(i + 1));
+                if (d.get<Data>(k)->size() != i + 1U) // only this thread writes this key
+                    failures++;
+                d.emplace(key, Data(i + 1, t)); // all threads write this key
+                if (d.getConst(key)->size() == 0)
+                    failures++;
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    REQUIRE(failures == 0);
+    REQUIRE(d.size() == nThreads + 1U);
+}
+#endif
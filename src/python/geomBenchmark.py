@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+Scaling benchmark on synthetic assemblies, generated by `pppAssemblyGenerator`
+
+For each assembly case, each action (check, detect, imprint) is run by `geomPipeline.py` in a child process
+with thread count from 1 to all hardware cores, the wall time and peak RSS of the child process are measured.
+Result is written into a json report: throughput (solids per second), speedup over single thread and peak RSS.
+
+`geomBenchmark.py --grid 10 10 10 --contact 0.6 --interference 0.1 --clearance 0.1 --curved 0.1 --shells 1`
+`geomBenchmark.py`  # run the default suite, it may take a long time
+"""
+
+USAGE = """
+geomBenchmark.py [--grid nx ny nz] [--actions check detect imprint] [--thread-counts 1 2 4] [-o report.json]
+"""
+
+import sys
+import os
+import os.path
+import json
+import time
+import shutil
+import platform
+import subprocess
+import argparse
+from multiprocessing import cpu_count
+
+generator_executable = "pppAssemblyGenerator"
+this_file_folder = os.path.dirname(os.path.abspath(__file__))
+if not shutil.which(generator_executable):
+    generator_executable = os.path.join(this_file_folder, generator_executable)
+pipeline_script = os.path.join(this_file_folder, "geomPipeline.py")
+
+# default suite, from loosely to deeply coupled assemblies
+default_cases = [
+    {"name": "cubes_contact", "grid": [10, 10, 10], "contact": 1.0, "interference": 0.0, "clearance": 0.0},
+    {"name": "cubes_mixed", "grid": [10, 10, 10], "contact": 0.6, "interference": 0.1, "clearance": 0.1},
+    {"name": "curved_mixed", "grid": [8, 8, 8], "contact": 0.6, "interference": 0.1, "clearance": 0.1,
+     "curved": 0.3},
+    {"name": "shelled_mixed", "grid": [8, 8, 8], "contact": 0.6, "interference": 0.1, "clearance": 0.1,
+     "shells": 2},
+]
+
+default_actions = ["check", "detect", "imprint"]
+
+
+def default_thread_counts():
+    # 1, 2, 4, ... and all cores
+    counts = []
+    n = 1
+    while n < cpu_count():
+        counts.append(n)
+        n *= 2
+    counts.append(cpu_count())
+    return counts
+
+
+def generate_case(case, working_dir):
+    filename = os.path.join(working_dir, case["name"] + ".brep")
+    cmd = [generator_executable, filename] + [str(n) for n in case["grid"]]
+    for key in ["size", "contact", "interference", "clearance", "curved", "shells", "overlap", "gap", "seed"]:
+        if key in case:
+            cmd.append("{}={}".format(key, case[key]))
+    output = subprocess.check_output(cmd)
+    return json.loads(output.decode("utf-8"))
+
+
+def peak_rss_mb(rusage):
+    # ru_maxrss is in KB on Linux, but in bytes on macOS
+    if sys.platform == "darwin":
+        return rusage.ru_maxrss / (1024.0 * 1024.0)
+    return rusage.ru_maxrss / 1024.0
+
+
+def run_pipeline(action, input_file, thread_count, working_dir):
+    """ return (return code, wall time in seconds, peak RSS in MB or None if not available) """
+    cmd = [sys.executable, pipeline_script, action, input_file, "--thread-count", str(thread_count),
+           "--working-dir", working_dir]
+    start = time.perf_counter()
+    p = subprocess.Popen(cmd, cwd=working_dir, stdout=subprocess.DEVNULL, stderr=subprocess.STDOUT)
+    if hasattr(os, "wait4"):  # POSIX only, rusage includes the pppGeomPipeline grandchild process
+        _, status, rusage = os.wait4(p.pid, 0)
+        elapsed = time.perf_counter() - start
+        p.returncode = os.WEXITSTATUS(status) if os.WIFEXITED(status) else -1
+        return p.returncode, elapsed, peak_rss_mb(rusage)
+    p.wait()
+    return p.returncode, time.perf_counter() - start, None
+
+
+def run_benchmark(cases, actions, thread_counts, working_dir):
+    report = {
+        "machine": {"platform": platform.platform(), "processor": platform.processor(), "cpuCount": cpu_count()},
+        "cases": [],
+        "results": [],
+    }
+    for case in cases:
+        case_dir = os.path.join(working_dir, case["name"])
+        os.makedirs(case_dir, exist_ok=True)
+        summary = generate_case(case, case_dir)
+        summary["name"] = case["name"]
+        report["cases"].append(summary)
+        for action in actions:
+            single_thread_time = None
+            for nt in thread_counts:
+                ret, elapsed, rss = run_pipeline(action, summary["fileName"], nt, case_dir)
+                if nt == 1 and ret == 0:
+                    single_thread_time = elapsed
+                result = {
+                    "case": case["name"],
+                    "action": action,
+                    "threadCount": nt,
+                    "solidCount": summary["solidCount"],
+                    "returnCode": ret,
+                    "wallTime": elapsed,
+                    "throughput": summary["solidCount"] / elapsed if elapsed > 0 else None,
+                    "speedup": single_thread_time / elapsed if single_thread_time and ret == 0 else None,
+                    "peakRSS": rss,  # MB
+                }
+                report["results"].append(result)
+                print("{case:>16} {action:>8} threads={threadCount:<4} time={wallTime:.2f}s".format(**result),
+                      "speedup={:.2f}".format(result["speedup"]) if result["speedup"] else "speedup=None",
+                      "peakRSS={:.1f}MB".format(rss) if rss else "peakRSS=None")
+    return report
+
+
+def benchmark_add_argument(parser):
+    parser.add_argument("--grid", type=int, nargs=3, help="run a single case of nx ny nz cells, instead of suite")
+    parser.add_argument("--size", type=float, default=10.0, help="cell edge length")
+    parser.add_argument("--contact", type=float, default=0.6, help="fraction of cells in contact with neighbours")
+    parser.add_argument("--interference", type=float, default=0.1, help="fraction of cells interfering")
+    parser.add_argument("--clearance", type=float, default=0.1, help="fraction of cells with small clearance")
+    parser.add_argument("--curved", type=float, default=0.0, help="fraction of cells as sphere or cylinder")
+    parser.add_argument("--shells", type=int, default=0, help="number of nested shells enclosing the grid")
+    parser.add_argument("--seed", type=int, default=0, help="random seed for the cell categories")
+    parser.add_argument("--actions", nargs="+", default=default_actions, help="geomPipeline.py actions")
+    parser.add_argument("--thread-counts", dest="thread_counts", type=int, nargs="+",
+                        help="thread counts to run, by default 1, 2, 4, ... and hardware core number")
+    parser.add_argument("--working-dir", dest="workingDir", default=os.getcwd(),
+                        help="folder to save generated geometry and pipeline result")
+    parser.add_argument("-o", "--output-file", dest="outputFile", default="benchmark_report.json",
+                        help="report file name relative to working-dir or absolute path")
+    return parser
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(usage=USAGE)
+    args = benchmark_add_argument(parser).parse_args()
+
+    if args.grid:
+        cases = [{"name": "grid_{}x{}x{}".format(*args.grid), "grid": args.grid, "size": args.size,
+                  "contact": args.contact, "interference": args.interference, "clearance": args.clearance,
+                  "curved": args.curved, "shells": args.shells, "seed": args.seed}]
+    else:
+        cases = default_cases
+    thread_counts = args.thread_counts if args.thread_counts else default_thread_counts()
+    if 1 not in thread_counts:  # speedup needs the single thread result
+        thread_counts = [1] + thread_counts
+
+    working_dir = os.path.abspath(args.workingDir)
+    report = run_benchmark(cases, args.actions, sorted(thread_counts), working_dir)
+
+    output_file = args.outputFile
+    if not os.path.isabs(output_file):
+        output_file = os.path.join(working_dir, output_file)
+    with open(output_file, "w") as f:
+        json.dump(report, f, indent=4)
+    print("benchmark report is written to", output_file)
@@ -200,6 +200,17 @@ readers = [  # it is possible to have multiple Reader instances in this list
         "className": "Geom::GeometryReader",
         "dataFileName": inputFile,
         "metadataFileName": None if not hasInputMetadataFile else os.path.abspath(inputMetadataFile),
+        "parallelTransfer": {
+            "type": "bool",
+            "value": False,
+            "doc": "translate root entities of STEP file in parallel threads, for very large STEP file",
+        },
+        "itemMemoryBudget": {
+            "type": "float",
+            "value": 0,
+            "unit": "MB",
+            "doc": "memory budget for shapes loaded on demand from an archive, zero to keep all shapes in memory",
+        },
         "doc": "only step, iges, FCStd, brep+json metadata are supported",
     }
 ]
@@ -218,6 +229,11 @@ writers = [
             "value": outputUnit,
             "doc": "control output geometry length unit, for CAD, default mm",
         },
+        "binaryBrep": {
+            "type": "bool",
+            "value": False,
+            "doc": "write brep output in OCCT binary format with file suffix `.bbrep`, faster for large assemblies",
+        },
         "doc": "if no directory part in `outputFile`, saved into the case `outputDir` folder",
     }
 ]
@@ -255,6 +271,18 @@ GeometryPropertyBuilder = {
         "value": "shape_properties.json",
         "doc": "this may used as meta data such as material, hash Id",
     },
+    "minimumVolume": {
+        "type": "quantity",
+        "value": 1.0,
+        "unit": "mm^3",
+        "doc": "item with volume smaller than this threshold is suppressed",
+    },
+    "maximumVolume": {
+        "type": "quantity",
+        "value": 1e16,
+        "unit": "mm^3",
+        "doc": "item with volume bigger than this threshold is reported as error",
+    },
 }
 
 BoundBoxBuilder = {
@@ -288,6 +316,16 @@ GeometrySearchBuilder = {
         "value": [[0, 0, 0, 10, 10, 10]],  # one BoundBox is a list of 6 scalars
         "doc": " search criteria values depends on search type",
     },
+    "boundBoxQuery": {
+        "type": "enum",
+        "value": "Coincident",
+        "doc": "relation for BoundBox search: Coincident, Intersect (overlapping), Contain (item inside the box)",
+    },
+    "boundBoxTolerance": {
+        "type": "float",
+        "value": 0.01,
+        "doc": "relative tolerance for Coincident, absolute tolerance in mm for Intersect and Contain",
+    },
 }
 
 CollisionDetector = {
@@ -323,6 +361,11 @@ CollisionDetector = {
         "value": True,
         "doc": "collision detection failed items will be suppressed if set True",
     },
+    "dumpFileType": {
+        "type": "string",
+        "value": ".brep",
+        "doc": "file suffix of dumped shapes for debugging, `.bbrep` for OCCT binary brep, or `.step`",
+    },
     "ignoreUnknownCollisionType": {
         "type": "bool",
         "value": suppressingBOPCheckFailed,
@@ -334,6 +377,33 @@ CollisionDetector = {
         "value": "myCollisionInfos.json",
         "doc": "collision type info dump, implemented in CollisionDetector parental class",
     },
+    "checkpoint": {
+        "type": "bool",
+        "value": False,
+        "doc": "save completed item pairs periodically into a checkpoint file, so an interrupted run can be resumed",
+    },
+    "checkpointInterval": {
+        "type": "float",
+        "value": 10.0,
+        "unit": "second",
+        "doc": "maximum time between two writes of buffered checkpoint records",
+    },
+    "phaseTiming": {
+        "type": "bool",
+        "value": False,
+        "doc": "time boolean and classification phases per item pair, aggregated into collisionPhaseTimes.json",
+    },
+    "pairTimeBudget": {
+        "type": "float",
+        "value": 0.0,
+        "unit": "second",
+        "doc": "wall time budget of an item pair, a timed-out pair is deferred to the end, zero for unlimited",
+    },
+    "timeoutRetryFactor": {
+        "type": "float",
+        "value": 4.0,
+        "doc": "deferred pairs are retried by a budget this times larger and a relaxed tolerance, zero to disable",
+    },
 }
 
 # Geom::CollisionDetector is now parental class for PPP::GeometryImprinter
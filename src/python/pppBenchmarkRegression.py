@@ -0,0 +1,274 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+Performance regression harness, compare the median wall time of a fixed benchmark suite with a stored baseline
+
+The suite consists of dispatcher micro-benchmarks (`pppDispatcherBenchmark`, no OCCT involved),
+imprint of a synthetic assembly (`pppAssemblyGenerator`) and pipelines on the bundled `data/test_geometry` files.
+Each case is run several times, the median is compared with the baseline json file,
+exit code is 1 if any case is slower than the baseline by more than the threshold, failed to run,
+or is in the baseline but did not run (e.g. data suite skipped), and 2 if the baseline is missing or not supported.
+
+Baseline is machine-specific, it is recorded by `--update-baseline` on the benchmark machine and kept there,
+then re-recorded after an intended performance change or on a new machine.
+`cmake --build . --target benchmark_baseline` records the baseline `benchmark_baseline.json` in the build folder,
+`cmake --build . --target benchmark_regression` compares with it, see cmake option `PPP_BENCHMARK_BASELINE`
+"""
+
+USAGE = """
+pppBenchmarkRegression.py [--baseline benchmark_baseline.json] [--repeat 3] [--threshold 0.3] [--update-baseline]
+"""
+
+import sys
+import os
+import os.path
+import json
+import shutil
+import platform
+import statistics
+import subprocess
+import tempfile
+import argparse
+from multiprocessing import cpu_count
+
+this_file_folder = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, this_file_folder)
+import geomBenchmark
+
+SCHEMA_VERSION = 1
+
+dispatcher_executable = "pppDispatcherBenchmark"
+if not shutil.which(dispatcher_executable):
+    dispatcher_executable = os.path.join(this_file_folder, dispatcher_executable)
+
+# this script is copied into build/bin, and installed into bin
+test_geometry_folders = [
+    os.path.join(this_file_folder, "..", "..", "data", "test_geometry"),
+    os.path.join(this_file_folder, "..", "data", "test_geometry"),
+]
+
+dispatcher_cases = [
+    {"name": "dispatcher_constant", "cost": "Constant"},
+    {"name": "dispatcher_heavy_tailed", "cost": "HeavyTailed"},
+    {"name": "dispatcher_hub_and_spoke", "cost": "HubAndSpoke"},
+]
+
+assembly_cases = [
+    {"name": "assembly_mixed", "grid": [6, 6, 6], "contact": 0.6, "interference": 0.1, "clearance": 0.1,
+     "curved": 0.2, "action": "imprint"},
+]
+
+# (file name in data/test_geometry, geomPipeline.py action)
+data_cases = [
+    ("test_geometry.stp", "imprint"),
+    ("test_cubes.stp", "imprint"),
+    ("test_interference.stp", "detect"),
+    ("test_geometry_manifest.json", "check"),
+]
+
+
+def git_version():
+    try:
+        output = subprocess.check_output(["git", "describe", "--always", "--dirty"], cwd=this_file_folder,
+                                         stderr=subprocess.DEVNULL)
+        return output.decode("utf-8").strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def machine_info():
+    return {"platform": platform.platform(), "processor": platform.processor(), "cpuCount": cpu_count()}
+
+
+def find_test_geometry_folder(data_dir=None):
+    if data_dir:
+        return os.path.abspath(data_dir) if os.path.exists(data_dir) else None
+    for folder in test_geometry_folders:
+        if os.path.exists(folder):
+            return os.path.abspath(folder)
+    return None
+
+
+def run_dispatcher_case(case, thread_count, working_dir):
+    """ return {metric name: wall time}, or None if failed """
+    output_file = os.path.join(working_dir, case["name"] + ".json")
+    cmd = [dispatcher_executable, "items=1000", "coupled=10", "mean=50", "batch=2", "cost=" + case["cost"],
+           "threads={}".format(thread_count), "output=" + output_file]
+    if subprocess.call(cmd, stdout=subprocess.DEVNULL) != 0:
+        return None
+    with open(output_file, "r") as f:
+        report = json.load(f)
+    # only the result of all threads, to keep the suite short
+    return {"{}/{}".format(case["name"], r["mode"]): r["wallTime"] for r in report["results"]
+            if r["threadCount"] == thread_count}
+
+
+def run_pipeline_case(name, action, input_file, thread_count, working_dir):
+    ret, elapsed, _ = geomBenchmark.run_pipeline(action, input_file, thread_count, working_dir)
+    if ret != 0:
+        return None
+    return {name: elapsed}
+
+
+def run_suite(repeat, thread_count, working_dir, suites, data_dir=None):
+    """ return ({metric name: [wall time of each run]}, [failed case names]) """
+    jobs = []  # (case name, function to run once)
+    if "dispatcher" in suites:
+        for case in dispatcher_cases:
+            jobs.append((case["name"], lambda case=case: run_dispatcher_case(case, thread_count, working_dir)))
+    if "assembly" in suites:
+        for case in assembly_cases:
+            case_dir = os.path.join(working_dir, case["name"])
+            os.makedirs(case_dir, exist_ok=True)
+            summary = geomBenchmark.generate_case(case, case_dir)
+            name = "{}/{}".format(case["name"], case["action"])
+            jobs.append((name, lambda name=name, case=case, summary=summary, case_dir=case_dir: run_pipeline_case(
+                name, case["action"], summary["fileName"], thread_count, case_dir)))
+    if "data" in suites:
+        data_folder = find_test_geometry_folder(data_dir)
+        if data_folder:
+            for filename, action in data_cases:
+                name = "{}/{}".format(os.path.splitext(filename)[0], action)
+                input_file = os.path.join(data_folder, filename)
+                jobs.append((name, lambda name=name, action=action, input_file=input_file: run_pipeline_case(
+                    name, action, input_file, thread_count, working_dir)))
+        else:
+            print("Warning: data/test_geometry folder is not found, data suite is skipped")
+
+    samples = {}
+    failed = []
+    for name, job in jobs:
+        for r in range(repeat):
+            result = job()
+            if result is None:
+                failed.append(name)
+                print("{:>40} run {} failed".format(name, r))
+                break
+            for metric, value in result.items():
+                samples.setdefault(metric, []).append(value)
+                print("{:>40} run {} {:.3f}s".format(metric, r, value))
+    return samples, failed
+
+
+def metric_suite(name):
+    """ name of the suite which the metric belongs to, None if the case is not in any suite """
+    case = name.split("/")[0]
+    if case in [c["name"] for c in dispatcher_cases]:
+        return "dispatcher"
+    if case in [c["name"] for c in assembly_cases]:
+        return "assembly"
+    if case in [os.path.splitext(filename)[0] for filename, _ in data_cases]:
+        return "data"
+    return None
+
+
+def compare(metrics, baseline, threshold, min_delta, suites):
+    """ return ({metric name: comparison}, [regressed metric names], [missing metric names])
+    a baseline metric of the selected suites but not in this run is missing
+    """
+    comparison = {}
+    regressions = []
+    missing = []
+    for name, m in sorted(metrics.items()):
+        if name not in baseline["metrics"]:
+            comparison[name] = {"median": m["median"], "status": "new"}
+            continue
+        base = baseline["metrics"][name]["median"]
+        ratio = m["median"] / base if base > 0 else float("inf")
+        # tiny cases are noisy, a regression must be significant both in ratio and in absolute time
+        regressed = ratio > 1.0 + threshold and m["median"] - base > min_delta
+        comparison[name] = {"median": m["median"], "baseline": base, "ratio": ratio,
+                            "status": "regressed" if regressed else "ok"}
+        if regressed:
+            regressions.append(name)
+    for name in baseline["metrics"]:
+        if name not in metrics and metric_suite(name) in suites:
+            comparison[name] = {"baseline": baseline["metrics"][name]["median"], "status": "missing"}
+            missing.append(name)
+    return comparison, regressions, missing
+
+
+def print_comparison(comparison):
+    print("{:>40} {:>10} {:>10} {:>8} {:>10}".format("case", "median(s)", "base(s)", "ratio", "status"))
+    for name, c in sorted(comparison.items()):
+        print("{:>40} {:>10} {:>10} {:>8} {:>10}".format(
+            name, "{:.3f}".format(c["median"]) if "median" in c else "-",
+            "{:.3f}".format(c["baseline"]) if "baseline" in c else "-",
+            "{:.2f}".format(c["ratio"]) if "ratio" in c else "-", c["status"]))
+
+
+def regression_add_argument(parser):
+    parser.add_argument("--baseline", default="benchmark_baseline.json", help="baseline json file")
+    parser.add_argument("--update-baseline", dest="update_baseline", action="store_true",
+                        help="save the result of this run as the baseline, instead of comparing")
+    parser.add_argument("--repeat", type=int, default=3, help="number of runs of each case, the median is compared")
+    parser.add_argument("--threshold", type=float, default=0.3,
+                        help="relative slowdown of median beyond which a case is regarded as regressed")
+    parser.add_argument("--min-delta", dest="min_delta", type=float, default=0.05,
+                        help="absolute slowdown in seconds below which a case is not regarded as regressed")
+    parser.add_argument("--suites", nargs="+", default=["dispatcher", "assembly", "data"],
+                        help="subset of the suites: dispatcher assembly data")
+    parser.add_argument("--data-dir", dest="data_dir", default=None,
+                        help="folder of the bundled test geometry, by default found relative to this script")
+    parser.add_argument("-nt", "--thread-count", dest="thread_count", type=int, default=cpu_count(),
+                        help="number of thread to use, by default, hardware core number")
+    parser.add_argument("--working-dir", dest="workingDir", default=None,
+                        help="folder to save generated geometry and results, by default a temporary folder")
+    parser.add_argument("-o", "--output-file", dest="outputFile", default="benchmark_regression.json",
+                        help="report file name")
+    return parser
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(usage=USAGE)
+    args = regression_add_argument(parser).parse_args()
+    # check before running the suite, a missing baseline must not pass silently as "no regression"
+    if not args.update_baseline and not os.path.exists(args.baseline):
+        print("Error: baseline file `{}` does not exist, record it by --update-baseline".format(args.baseline))
+        sys.exit(2)
+
+    working_dir = os.path.abspath(args.workingDir) if args.workingDir else tempfile.mkdtemp(prefix="ppp_benchmark_")
+    os.makedirs(working_dir, exist_ok=True)
+    samples, failed = run_suite(args.repeat, args.thread_count, working_dir, args.suites, args.data_dir)
+
+    result = {
+        "schemaVersion": SCHEMA_VERSION,
+        "version": git_version(),
+        "machine": machine_info(),
+        "threadCount": args.thread_count,
+        "repeat": args.repeat,
+        "metrics": {name: {"median": statistics.median(s), "samples": s} for name, s in samples.items()},
+    }
+
+    if args.update_baseline:
+        with open(args.baseline, "w") as f:
+            json.dump(result, f, indent=4)
+        print("baseline is written to", args.baseline, ", keep it on this machine to compare with later runs")
+        sys.exit(1 if failed else 0)
+
+    with open(args.baseline, "r") as f:
+        baseline = json.load(f)
+    if baseline.get("schemaVersion") != SCHEMA_VERSION:
+        print("Error: baseline schema version {} is not supported, please update baseline".format(
+            baseline.get("schemaVersion")))
+        sys.exit(2)
+    if baseline.get("machine") != result["machine"] or baseline.get("threadCount") != args.thread_count:
+        print("Warning: baseline was recorded on a different machine or thread count, comparison may be invalid")
+
+    comparison, regressions, missing = compare(result["metrics"], baseline, args.threshold, args.min_delta,
+                                               args.suites)
+    result["baseline"] = {"file": os.path.abspath(args.baseline), "version": baseline.get("version")}
+    result["comparison"] = comparison
+    result["regressions"] = regressions
+    result["failed"] = failed
+    result["missing"] = missing
+    with open(args.outputFile, "w") as f:
+        json.dump(result, f, indent=4)
+    print_comparison(comparison)
+    print("regression report is written to", args.outputFile)
+
+    if regressions or failed or missing:
+        print("Error: {} regressed, {} failed and {} missing cases, threshold = {}".format(
+            len(regressions), len(failed), len(missing), args.threshold))
+        sys.exit(1)
@@ -82,6 +82,34 @@ def ppp_add_argument(parser):
         help="number of thread to use, by default, hardware core number",
     )
 
+    parser.add_argument(
+        "--profile",
+        action="store_true",
+        help="record time of each item and item pair processing, save into the output folder",
+    )
+
+    parser.add_argument(
+        "--trace",
+        action="store_true",
+        help="record timeline of processors and worker threads, save `pipeline_trace.json` for chrome://tracing",
+    )
+
+    parser.add_argument(
+        "--progress-file",
+        dest="progress_file",
+        type=str,
+        default="",
+        help="write JSON-lines progress (stage, done/total, rate, eta) to this file, relative to the output folder",
+    )
+
+    parser.add_argument(
+        "--memory-budget",
+        dest="memory_budget",
+        type=float,
+        default=0.0,
+        help="memory budget in MB, warn before a processor which may exceed it, zero to disable",
+    )
+
     parser.add_argument(
         "-v",
         "--verbosity",
@@ -147,6 +175,15 @@ def generate_config_file_header(args):
                 "numberOfNodes": 1,  # MPI nodes, currently only 1
                 "threadsOnNode": args.thread_count,  # <1 mean hardware thread count
                 "sharedMemoryAddress": True,  # shared memory address on each node
+                "maxInFlightDatasets": 0,  # >0: write output in background while processing next input
+                "concurrentInputs": 0,  # >1: process this number of input files concurrently
+                "profileItems": args.profile,  # time each item/pair processing, save `*_profile.csv`
+                "profileTopCount": 10,  # the slowest calls listed in `processed_info.json`
+                "traceFile": "pipeline_trace.json" if args.trace else "",  # Chrome trace-event timeline
+                "progressFile": args.progress_file,  # JSON-lines progress stream, empty to disable
+                "progressInterval": 1.0,  # seconds between two progress lines
+                "memoryBudget": args.memory_budget,  # MB, warn if a processor may exceed it, zero to disable
+                "memorySamplingInterval": 0.1,  # seconds, per-processor peak RSS saved in `processed_info.json`
             },
             "dataStorage": {
                 "workingDir": args.workingDir,